@@ -0,0 +1,14 @@
+// Author: Burak Özdemir
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+/// @brief Checks whether the host stores integers little-endian.
+/// Feature files and binary exports are little-endian; on such hosts their columns are written and mapped as they are.
+/// @return True on little-endian hosts.
+inline bool hostIsLittleEndian() {
+	const uint16_t probe = 1;
+	unsigned char first;
+	memcpy(&first, &probe, 1);
+	return first == 1;
+}
@@ -25,6 +25,47 @@ CommonProcesses::~CommonProcesses() {
 	cout << "CommonProcesses destructor of the " << getID() << " object, Count ="<<count << endl;
 }
 
+/// @details This copy constructor shares the image data of the other object (Mat reference counting) and copies the other members.
+CommonProcesses::CommonProcesses(const CommonProcesses& other)
+	:ID(other.ID), image(other.image), weight(other.weight), height(other.height), path(other.path), imageVersion(other.imageVersion), precision(other.precision)
+{
+	count += 1;
+	cout << "CommonProcesses copy constructor of the " << getID() << " object, Count =" << count << endl;
+}
+
+/// @details This move constructor takes over the image buffer of the other object without touching its reference count.
+/// It lets transforms return their result (and temporaries pass their buffer along a chain) without copies.
+CommonProcesses::CommonProcesses(CommonProcesses&& other) noexcept
+	:ID(std::move(other.ID)), image(std::move(other.image)), weight(other.weight), height(other.height), path(std::move(other.path)), imageVersion(other.imageVersion), precision(other.precision)
+{
+	count += 1;
+	cout << "CommonProcesses move constructor of the " << getID() << " object, Count =" << count << endl;
+}
+
+/// @details This copy assignment operator shares the image data of the other object and copies the other members.
+CommonProcesses& CommonProcesses::operator=(const CommonProcesses& other) {
+	ID = other.ID;
+	image = other.image;
+	imageVersion = other.imageVersion;
+	weight = other.weight;
+	height = other.height;
+	path = other.path;
+	precision = other.precision;
+	return *this;
+}
+
+/// @details This move assignment operator takes over the image buffer of the other object.
+CommonProcesses& CommonProcesses::operator=(CommonProcesses&& other) noexcept {
+	ID = std::move(other.ID);
+	image = std::move(other.image);
+	imageVersion = other.imageVersion;
+	weight = other.weight;
+	height = other.height;
+	path = std::move(other.path);
+	precision = other.precision;
+	return *this;
+}
+
 /// @details This function sets the ID of the CommonProcesses object with the specified ID.
 void CommonProcesses::setID(string id) {
 	ID = id;
@@ -39,12 +80,95 @@ string CommonProcesses::getID(){
 /// @details This function sets the image data member of the CommonProcesses object with the specified image.
 void CommonProcesses::setImage(Mat img) {
 	image = img;
+	imageVersion = nextImageVersion();
+}
+
+/// @details This function returns the image version. Every change of the image draws a new version from one global counter,
+/// so two objects never hold the same version for different images. Copies and moves keep the version with the image.
+uint64_t CommonProcesses::getImageVersion() {
+	return imageVersion;
+}
+
+/// @details This static function returns a version no object has used yet.
+uint64_t CommonProcesses::nextImageVersion() {
+	static atomic<uint64_t> lastVersion(0);
+	return lastVersion.fetch_add(1, memory_order_relaxed) + 1;
 }
 
 /// @details This function returns the image data member of the CommonProcesses object.
 Mat CommonProcesses::getImage(){
 	return image;
 }
+/// @details This function sets the precision policy and stores the current image in it.
+/// Every operation of the object (and the objects it creates) stores its result in this precision.
+void CommonProcesses::setPrecision(PixelPrecision p) {
+	TRACE_SCOPE("CommonProcesses::setPrecision");
+	precision = p;
+	if (!image.empty())
+		image = storeImage(image);
+	imageVersion = nextImageVersion();
+}
+
+/// @details This function returns the precision policy of the CommonProcesses object.
+PixelPrecision CommonProcesses::getPrecision() {
+	return precision;
+}
+
+/// @details This static function maps a precision policy to an image depth.
+int CommonProcesses::precisionDepth(PixelPrecision p) {
+	switch (p) {
+	case PRECISION_U8:  return CV_8U;
+	case PRECISION_U16: return CV_16U;
+	case PRECISION_F16: return CV_16F;
+	case PRECISION_F32: return CV_32F;
+	default:            return -1;
+	}
+}
+
+/// @details This static function converts an image to another depth and rescales it between the normalized ranges
+/// (255 for CV_8U, 65535 for CV_16U, 1 for floating point) so that e.g. a CV_8U 255 becomes a CV_16F 1.0.
+/// Conversions from and to CV_16F use OpenCV's vectorized half float conversion.
+Mat CommonProcesses::convertDepth(Mat img, int depth) {
+	if (img.empty() || img.depth() == depth)
+		return img;
+	Mat converted;
+	img.convertTo(converted, depth, normalizedMax(depth) / normalizedMax(img.depth()));
+	return converted;
+}
+
+/// @details This function returns the image in a depth OpenCV can compute on.
+/// Most OpenCV functions do not accept CV_16F, so half float images are widened to CV_32F on load.
+Mat CommonProcesses::computeImage() {
+	if (image.depth() == CV_16F)
+		return convertDepth(image, CV_32F);
+	return image;
+}
+
+/// @details This function returns the image as an output buffer an operation may overwrite in place.
+/// The buffer is only handed out when no other object or Mat shares it (copies share image data) and it is not
+/// half float (half float is widened before computing). Otherwise an empty Mat is returned, so the operation allocates.
+Mat CommonProcesses::reusableImage() {
+	if (image.u == nullptr || image.u->refcount != 1 || image.depth() == CV_16F)
+		return Mat();
+	return image;
+}
+
+/// @details This function stores an operation result in the depth of the precision policy.
+Mat CommonProcesses::storeImage(Mat result) {
+	int depth = precisionDepth(precision);
+	if (depth < 0)
+		return result;
+	return convertDepth(result, depth);
+}
+
+/// @details This function creates the object returned by an operation. The result is stored in the precision policy
+/// and the new object inherits the policy, so chained operations keep the same precision.
+CommonProcesses CommonProcesses::makeResult(string id, Mat result) {
+	CommonProcesses obj(id, storeImage(result));
+	obj.precision = precision;
+	return obj;
+}
+
 /// @details This function sets the file path for the CommonProcesses object with the specified path.
 void CommonProcesses::setPath(string p)
 {
@@ -80,48 +204,70 @@ int CommonProcesses::getWidth()
 
 /// @details This function reads and returns an image with getPath().
 Mat CommonProcesses::readImage(){
+	TRACE_SCOPE("CommonProcesses::readImage");
 	Mat img = imread(getPath(), IMREAD_COLOR);
 	return img;
 }
 /// @details This static function can be used independently of an object. It reads and returns an image from the specified file path.
 Mat CommonProcesses::readImage(string p) {
+	TRACE_SCOPE("CommonProcesses::readImage");
 	Mat img = imread(p, IMREAD_COLOR);
 	return img;
 }
 /// @details This function saves the image to the directory where the code is located.
 void CommonProcesses::saveImage(){
-	imwrite(path+getID() + ".jpg", image);
+	TRACE_SCOPE("CommonProcesses::saveImage");
+	imwrite(path+getID() + ".jpg", computeImage());
 }
 
 
 /// @details This function saves the image to the specified file path.
 void CommonProcesses::saveImage(string p) {
-	imwrite(p, image);
+	TRACE_SCOPE("CommonProcesses::saveImage");
+	imwrite(p, computeImage());
 }
 
 /// @details This function displays the image on the screen.
 void CommonProcesses::showImage() {
-	imshow("Output image "+ID, image);
+	TRACE_SCOPE("CommonProcesses::showImage");
+	imshow("Output image "+ID, computeImage());
 	int k = waitKey(0);
 }
 
 /// @details This static function rescales the input image to the specified height and width and it returns the resize image.
 Mat CommonProcesses::rescaleImage(Mat img,int h, int w) {
+	TRACE_SCOPE("CommonProcesses::rescaleImage");
 	Mat resize_img;
 	resize(img, resize_img, Size(w, h), INTER_LINEAR);
 	return resize_img;
 }
 
 /// @details This member function rescales the CommonProcesses object's image to the specified height and width and it returns new object.
-CommonProcesses CommonProcesses::rescaleImage(int h,int w) {
+CommonProcesses CommonProcesses::rescaleImage(int h,int w) & {
+	TRACE_SCOPE("CommonProcesses::rescaleImage");
 	Mat resize_img;
-	resize(getImage(), resize_img, Size(w, h), INTER_LINEAR);
-	return CommonProcesses(getID() + "_resize", resize_img);
+	resize(computeImage(), resize_img, Size(w, h), INTER_LINEAR);
+	return makeResult(getID() + "_resize", resize_img);
+}
+
+/// @details This member function rescales the image of a temporary object and moves the object out.
+/// The image is left untouched when it already has the requested size.
+CommonProcesses CommonProcesses::rescaleImage(int h, int w) && {
+	TRACE_SCOPE("CommonProcesses::rescaleImage");
+	if (image.size() != Size(w, h)) {
+		Mat resize_img;
+		resize(computeImage(), resize_img, Size(w, h), INTER_LINEAR);
+		image = storeImage(resize_img);
+		imageVersion = nextImageVersion();
+	}
+	setID(getID() + "_resize");
+	return std::move(*this);
 }
 
 
 /// @details This static function reduces noise in the input image and it returns current image.
 Mat CommonProcesses::reduceNoise(Mat img) {
+	TRACE_SCOPE("CommonProcesses::reduceNoise");
 	Mat reduce_noise_img;
 	fastNlMeansDenoisingColored(img, reduce_noise_img, 30, 7, 3, 10);
 	return reduce_noise_img;
@@ -129,16 +275,33 @@ Mat CommonProcesses::reduceNoise(Mat img) {
 
 
 /// @details This member function reduces noise in the CommonProcesses object's image and it returns new object .
-CommonProcesses CommonProcesses::reduceNoise() {
+CommonProcesses CommonProcesses::reduceNoise() & {
+	TRACE_SCOPE("CommonProcesses::reduceNoise");
+	Mat reduce_noise_img;
+	fastNlMeansDenoisingColored(convertDepth(getImage(), CV_8U), reduce_noise_img, 30, 7, 3, 10);
+
+	return makeResult(getID() + "_reduceNoise", reduce_noise_img);
+}
+
+/// @details This member function reduces noise in the image of a temporary object and moves the object out.
+/// fastNlMeansDenoisingColored cannot work in place, so the old buffer is released as soon as the result is set.
+CommonProcesses CommonProcesses::reduceNoise() && {
+	TRACE_SCOPE("CommonProcesses::reduceNoise");
 	Mat reduce_noise_img;
-	fastNlMeansDenoisingColored(getImage(), reduce_noise_img, 30, 7, 3, 10);
+	fastNlMeansDenoisingColored(convertDepth(getImage(), CV_8U), reduce_noise_img, 30, 7, 3, 10);
+	image = storeImage(reduce_noise_img);
+	imageVersion = nextImageVersion();
 
-	return CommonProcesses(getID() + "_reduceNoise", reduce_noise_img);
+	setID(getID() + "_reduceNoise");
+	return std::move(*this);
 }
 
 
 /// @details This static function converts the input image to grayscaleand returns gray scale image.
 Mat CommonProcesses::RGB2Gray(Mat img) {
+	TRACE_SCOPE("CommonProcesses::RGB2Gray");
+	if (img.channels() == 1)
+		return img;
 	Mat grayImg;
 	cvtColor(img, grayImg, COLOR_BGR2GRAY);
 	return grayImg;
@@ -146,64 +309,188 @@ Mat CommonProcesses::RGB2Gray(Mat img) {
 
 
 /// @details This member function converts the CommonProcesses object's image to grayscale and it returns new object.
-CommonProcesses CommonProcesses::RGB2Gray() {
+CommonProcesses CommonProcesses::RGB2Gray() & {
+	TRACE_SCOPE("CommonProcesses::RGB2Gray");
 	Mat grayImg;
-	cvtColor(getImage(), grayImg, COLOR_BGR2GRAY);
+	cvtColor(computeImage(), grayImg, COLOR_BGR2GRAY);
 
-	return CommonProcesses(getID() + "_2Gray", grayImg);
+	return makeResult(getID() + "_2Gray", grayImg);
 }
 
-/// @details This member function normalizes the CommonProcesses object's image.
-CommonProcesses CommonProcesses::normalizeImage() {
+/// @details This member function converts the image of a temporary object to grayscale and moves the object out.
+CommonProcesses CommonProcesses::RGB2Gray() && {
+	TRACE_SCOPE("CommonProcesses::RGB2Gray");
+	Mat grayImg;
+	cvtColor(computeImage(), grayImg, COLOR_BGR2GRAY);
+	image = storeImage(grayImg);
+	imageVersion = nextImageVersion();
+
+	setID(getID() + "_2Gray");
+	return std::move(*this);
+}
+
+/// @details This static function returns the value the maximum pixel is mapped to by normalization.
+/// Integer depths use their full unsigned range (unorm), floating point depths use [0, 1].
+double CommonProcesses::normalizedMax(int depth) {
+	switch (depth) {
+	case CV_8U:  return 255.0;
+	case CV_16U: return 65535.0;
+	case CV_16F:
+	case CV_32F:
+	case CV_64F: return 1.0;
+	default:
+		CV_Error(Error::StsUnsupportedFormat, "normalizeImage supports CV_8U, CV_16U, CV_16F, CV_32F and CV_64F");
+	}
+	return 1.0;
+}
+
+/// @details This static function finds the minimum and maximum of all channels in a single pass and then
+/// scales and converts the image to the requested depth in a second pass, without an intermediate CV_32F image.
+/// When src and dst are the same image and the depth is unchanged, the data is rewritten in place.
+void CommonProcesses::normalizeMinMax(const Mat& src, Mat& dst, int rtype) {
+	double minVal = 0, maxVal = 0;
+	minMaxLoc(src.depth() == CV_16F ? convertDepth(src, CV_32F).reshape(1) : src.reshape(1), &minVal, &maxVal);
+
+	double scale = maxVal > minVal ? normalizedMax(rtype) / (maxVal - minVal) : 0.0;
+	src.convertTo(dst, rtype, scale, -minVal * scale);
+}
+
+/// @details This member function normalizes the CommonProcesses object's image into the given output depth.
+/// CV_8U and CV_16U outputs span the full integer range, CV_16F, CV_32F and CV_64F outputs span [0, 1].
+/// Without an explicit depth the precision policy is used, or CV_32F when the policy is PRECISION_NATIVE.
+CommonProcesses CommonProcesses::normalizeImage(int rtype) & {
+	TRACE_SCOPE("CommonProcesses::normalizeImage");
+	if (rtype < 0)
+		rtype = precisionDepth(precision) < 0 ? CV_32F : precisionDepth(precision);
 	Mat normalized_image;
-	normalize(this->getImage(), normalized_image, 0, 1, NORM_MINMAX, CV_32F);
-	return CommonProcesses(this->getID()+"_normalize", normalized_image);
+	normalizeMinMax(getImage(), normalized_image, rtype);
+	CommonProcesses obj(this->getID()+"_normalize", normalized_image);
+	obj.precision = precision;
+	return obj;
+}
+
+/// @details This member function normalizes the image of a temporary object and moves the object out.
+/// When the output depth equals the current depth and the buffer is not shared, the image buffer is rewritten in place.
+CommonProcesses CommonProcesses::normalizeImage(int rtype) && {
+	TRACE_SCOPE("CommonProcesses::normalizeImage");
+	if (rtype < 0)
+		rtype = precisionDepth(precision) < 0 ? CV_32F : precisionDepth(precision);
+	Mat result = reusableImage();
+	normalizeMinMax(image, result, rtype);
+	image = result;
+	imageVersion = nextImageVersion();
+
+	setID(getID() + "_normalize");
+	return std::move(*this);
+}
+
+/// @details This member function normalizes the CommonProcesses object's image into its own buffer.
+/// The image keeps its type, so no new image is allocated.
+CommonProcesses& CommonProcesses::normalizeImageInPlace() {
+	TRACE_SCOPE("CommonProcesses::normalizeImageInPlace");
+	normalizeMinMax(image, image, image.depth());
+	imageVersion = nextImageVersion();
+	return *this;
+}
+
+/// @details This static function returns the structuring element used by erosion and dilation.
+/// It is built once instead of on every call.
+const Mat& CommonProcesses::morphologyKernel() {
+	static const Mat kernel = getStructuringElement(MORPH_RECT, Size(50, 50));
+	return kernel;
 }
 
 /// @details This member function applies erosion to the CommonProcesses object's image  and it returns new object.
-CommonProcesses CommonProcesses::erosion() {
+CommonProcesses CommonProcesses::erosion() & {
+	TRACE_SCOPE("CommonProcesses::erosion");
 	Mat eroded_image;
-	Mat kernel = getStructuringElement(MORPH_RECT, Size(50, 50));
-	erode(image, eroded_image, kernel);
+	erode(computeImage(), eroded_image, morphologyKernel());
+
+	return makeResult(this->getID() + "_erode", eroded_image);
+}
+
+/// @details This member function applies erosion to the image of a temporary object and moves the object out.
+/// Unless the buffer is shared, erode writes into the image buffer itself, so no new image is allocated.
+CommonProcesses CommonProcesses::erosion() && {
+	TRACE_SCOPE("CommonProcesses::erosion");
+	Mat result = reusableImage();
+	erode(computeImage(), result, morphologyKernel());
+	image = storeImage(result);
+	imageVersion = nextImageVersion();
 
-	return CommonProcesses(this->getID() + "_erode", eroded_image);
+	setID(getID() + "_erode");
+	return std::move(*this);
 }
 
 /// @details This member function applies dilation to the CommonProcesses object's image.
-CommonProcesses CommonProcesses::dilation() {
+CommonProcesses CommonProcesses::dilation() & {
+	TRACE_SCOPE("CommonProcesses::dilation");
 	Mat dilated_image;
-	Mat kernel = getStructuringElement(MORPH_RECT, Size(50, 50));
-	dilate(image, dilated_image, kernel);
+	dilate(computeImage(), dilated_image, morphologyKernel());
 
-	return CommonProcesses(this->getID() + "_dilate", dilated_image);
+	return makeResult(this->getID() + "_dilate", dilated_image);
+}
+
+/// @details This member function applies dilation to the image of a temporary object and moves the object out.
+/// Unless the buffer is shared, dilate writes into the image buffer itself, so no new image is allocated.
+CommonProcesses CommonProcesses::dilation() && {
+	TRACE_SCOPE("CommonProcesses::dilation");
+	Mat result = reusableImage();
+	dilate(computeImage(), result, morphologyKernel());
+	image = storeImage(result);
+	imageVersion = nextImageVersion();
+
+	setID(getID() + "_dilate");
+	return std::move(*this);
 }
 
 /// @details This member function applies opening operation (combination of erosion and dilation member functions) to the CommonProcesses object's image.
-CommonProcesses CommonProcesses::openImage() {
+CommonProcesses CommonProcesses::openImage() & {
+	TRACE_SCOPE("CommonProcesses::openImage");
 
 	CommonProcesses e = this->erosion();
 	CommonProcesses d = e.dilation();
 
-	return CommonProcesses(this->getID() + "_opened", d.getImage());
+	return makeResult(this->getID() + "_opened", d.getImage());
 
 }
 
 /// @details This member function applies closing operation (combination of dilation and erosion member functions) to the CommonProcesses object's image.
-CommonProcesses CommonProcesses::closeImage() {
+CommonProcesses CommonProcesses::closeImage() & {
+	TRACE_SCOPE("CommonProcesses::closeImage");
 
 	CommonProcesses d = this->dilation();
 	CommonProcesses e = d.erosion();
 
-	return CommonProcesses(this->getID() + "_opened", e.getImage());
+	return makeResult(this->getID() + "_closed", e.getImage());
+}
+
+/// @details This member function applies opening operation to the image of a temporary object in place and moves the object out.
+CommonProcesses CommonProcesses::openImage() && {
+	TRACE_SCOPE("CommonProcesses::openImage");
+	string id = getID() + "_opened";
+	CommonProcesses opened = std::move(*this).erosion().dilation();
+	opened.setID(id);
+	return opened;
+}
+
+/// @details This member function applies closing operation to the image of a temporary object in place and moves the object out.
+CommonProcesses CommonProcesses::closeImage() && {
+	TRACE_SCOPE("CommonProcesses::closeImage");
+	string id = getID() + "_closed";
+	CommonProcesses closed = std::move(*this).dilation().erosion();
+	closed.setID(id);
+	return closed;
 }
 
 /// @details This member function calculates the histogram of the CommonProcesses object's image and returns histogram matrix.
 Mat CommonProcesses::calculateHistogram() {
+	TRACE_SCOPE("CommonProcesses::calculateHistogram");
 	int histSize = 256;
 	float range[] = { 0, 256 };
 	const float* histRange = { range };
 	Mat hist;
-	Mat img = RGB2Gray(getImage());
+	Mat img = convertDepth(RGB2Gray(computeImage()), CV_8U);
 	calcHist(&img, 1, 0, Mat(), hist, 1, &histSize, &histRange, true, false);
 	for (int i = 0; i < histSize; i++) {
 		cout << "Value " << i << ": " << hist.at<float>(i) << " px" << endl;
@@ -214,6 +501,7 @@ Mat CommonProcesses::calculateHistogram() {
 /// @details This member function visualizes histogram with matplotlib libary.
 /// This function uses calculateHistogram function. 
 void CommonProcesses::visualizeHistogram() {
+	TRACE_SCOPE("CommonProcesses::visualizeHistogram");
 	namespace plt = matplotlibcpp;
 
 	Mat hist = calculateHistogram();
@@ -252,66 +540,74 @@ ostream& operator<<(ostream &output, CommonProcesses &image_object)
 /// First, it checks the dimensions of the two images and if their sizes are not equal, it makes them equal by applying the resize operation.
 /// It then adds the two images. Returns the new object.
 CommonProcesses CommonProcesses::operator+(CommonProcesses& obj) {
-	cv::Mat resizedImage;
+	TRACE_SCOPE("CommonProcesses::operator+");
+	cv::Mat resizedImage = this->computeImage();
+	cv::Mat other = convertDepth(obj.computeImage(), resizedImage.depth());
 
-	if (this->getImage().size() != obj.getImage().size()) {
-		resize(this->getImage(), resizedImage, obj.getImage().size());
+	if (resizedImage.size() != other.size()) {
+		resize(this->computeImage(), resizedImage, other.size());
 	}
 	cv::Mat sum;
-	cv::add(resizedImage, obj.getImage(), sum);
+	cv::add(resizedImage, other, sum);
 
 	string id_ = "sumof_image" + this->getID() + "_and_" + obj.getID();
-	return CommonProcesses(id_, sum);;
+	return makeResult(id_, sum);
 }
 
 /// @details This operator subtracts the image of the specified CommonProcesses object from the image of the current object.
 /// First, it checks the dimensions of the two images and if their sizes are not equal, it makes them equal by applying the resize operation.
 /// It then subtracts the two images from each other. Returns the new object.
 CommonProcesses CommonProcesses::operator-(CommonProcesses &obj) {
-	cv::Mat resizedImage;
+	TRACE_SCOPE("CommonProcesses::operator-");
+	cv::Mat resizedImage = this->computeImage();
+	cv::Mat other = convertDepth(obj.computeImage(), resizedImage.depth());
 
-	if (this->getImage().size() != obj.getImage().size()) {
-		resize(this->getImage(), resizedImage, obj.getImage().size());
+	if (resizedImage.size() != other.size()) {
+		resize(this->computeImage(), resizedImage, other.size());
 	}
 	Mat difference;
-	absdiff(resizedImage, obj.getImage(), difference);
+	absdiff(resizedImage, other, difference);
 
-	return CommonProcesses("differenceof_" + this->getID() + "_and_" + obj.getID(), difference);
+	return makeResult("differenceof_" + this->getID() + "_and_" + obj.getID(), difference);
 }
 
 // @details This operator rotates the image of the CommonProcesses object by the specified degree.
 CommonProcesses CommonProcesses::operator+(int degree) {
+	TRACE_SCOPE("CommonProcesses::operator+(int)");
 	int width = getWidth();
 	int height = getHeight();
 
 	Point2f center(float(width / 2), float(height / 2));
 	Mat rotated_image;
-	warpAffine(getImage(), rotated_image, getRotationMatrix2D(center, degree, 1.0), getImage().size());
+	warpAffine(computeImage(), rotated_image, getRotationMatrix2D(center, degree, 1.0), getImage().size());
 
-	return CommonProcesses(getID() + to_string(degree) + "_degreeRotate", rotated_image);
+	return makeResult(getID() + to_string(degree) + "_degreeRotate", rotated_image);
 }
 
 /// @details This operator rotates the image of the CommonProcesses object in the opposite direction (counter clock wise) of the specified degree.
 CommonProcesses CommonProcesses::operator-(int degree){
+	TRACE_SCOPE("CommonProcesses::operator-(int)");
 	int width = getWidth();
 	int height = getHeight();
 
 	Point2f center(float(width / 2), float(height / 2));
 	Mat rotated_image;
-	warpAffine(getImage(), rotated_image, getRotationMatrix2D(center,(360 - degree), 1.0), getImage().size());
+	warpAffine(computeImage(), rotated_image, getRotationMatrix2D(center,(360 - degree), 1.0), getImage().size());
 
-	return CommonProcesses(getID() +"_minus" + to_string(degree) + "degreeRotate", rotated_image);
+	return makeResult(getID() +"_minus" + to_string(degree) + "degreeRotate", rotated_image);
 }
 
 /// @details This operator rescales the image of the CommonProcesses object by the specified factor.
 /// This function uses rescaleImage member function. Ex: new_obj = obj*2 (The size of the image doubles.)
 CommonProcesses CommonProcesses::operator*(int scale) {
+	TRACE_SCOPE("CommonProcesses::operator*");
 
 	return rescaleImage(getHeight() * scale, getWidth() * scale);
 }
 
 /// @details This operator rescales the image of the CommonProcesses object by dividing its size by the specified factor.
 CommonProcesses CommonProcesses::operator/(int scale) {
+	TRACE_SCOPE("CommonProcesses::operator/");
 	return rescaleImage(getHeight()  / scale, getWidth()  / scale);
 }
 
@@ -6,11 +6,23 @@
 #include "opencv2/core.hpp"
 #include <opencv2/highgui/highgui.hpp>
 #include <iomanip>
+#include <atomic>
 #include "matplotlibcpp.h"
+#include "Trace.h"
 
 using namespace std;
 using namespace cv;
 
+/// @brief Pixel storage precision policy for the images produced by CommonProcesses operations.
+/// Integer precisions store the full unsigned range (unorm), floating point precisions store [0, 1].
+enum PixelPrecision {
+	PRECISION_NATIVE, ///< Keep the depth each operation naturally produces.
+	PRECISION_U8,     ///< 8-bit unsigned (CV_8U).
+	PRECISION_U16,    ///< 16-bit unsigned (CV_16U).
+	PRECISION_F16,    ///< 16-bit half float (CV_16F).
+	PRECISION_F32     ///< 32-bit float (CV_32F).
+};
+
 /// @brief CommonProcesses class for various image processing operations.
 /// This class is designed to handle operations such as storing raw RGB data, displaying it on a viewer,
 /// reading RGB data from a file, writing RGB data to a file, showing RGB data on the viewer,
@@ -40,6 +52,24 @@ class CommonProcesses{
 		/// @param path The file path from which to read the image.
 		CommonProcesses(string,string); 
 
+		/// @brief Copy constructor for the CommonProcesses class. The image data is shared, not deep copied.
+		/// @param other The CommonProcesses object to copy.
+		CommonProcesses(const CommonProcesses&);
+
+		/// @brief Move constructor for the CommonProcesses class. The image buffer is taken over from the other object.
+		/// @param other The CommonProcesses object to move from.
+		CommonProcesses(CommonProcesses&&) noexcept;
+
+		/// @brief Copy assignment operator for the CommonProcesses class.
+		/// @param other The CommonProcesses object to copy.
+		/// @return A reference to this object.
+		CommonProcesses& operator=(const CommonProcesses&);
+
+		/// @brief Move assignment operator for the CommonProcesses class.
+		/// @param other The CommonProcesses object to move from.
+		/// @return A reference to this object.
+		CommonProcesses& operator=(CommonProcesses&&) noexcept;
+
 		/// @brief Sets the image data member of the CommonProcesses object.
 		/// @param image The image to set as the new image data member.
 		void setImage(Mat);
@@ -64,6 +94,14 @@ class CommonProcesses{
 		/// @return The file path.
 		string getPath();
 
+		/// @brief Sets the pixel precision policy and converts the current image to it.
+		/// @param precision The precision every following operation stores its result in.
+		void setPrecision(PixelPrecision);
+
+		/// @brief Gets the pixel precision policy of the CommonProcesses object.
+		/// @return The pixel precision policy.
+		PixelPrecision getPrecision();
+
 		/// @brief Reads an image and sets it as the data member of CommonProcesses.
 		/// @return The read image data.
 		Mat readImage(); 
@@ -94,7 +132,13 @@ class CommonProcesses{
 		/// @param h The target height of the rescaled image.
 		/// @param w The target width of the rescaled image.
 		/// @return A new CommonProcesses object with the rescaled image. 
-		CommonProcesses rescaleImage(int,int);
+		CommonProcesses rescaleImage(int,int) &;
+
+		/// @brief Rescales the image of a temporary object to the specified height and width.
+		/// @param h The target height of the rescaled image.
+		/// @param w The target width of the rescaled image.
+		/// @return The temporary object moved out, holding the rescaled image.
+		CommonProcesses rescaleImage(int,int) &&;
 
 		/// @brief Reduces noise in the image.
 		/// @param img The input image from which to reduce noise.
@@ -103,37 +147,77 @@ class CommonProcesses{
 
 		/// @brief Reduces noise in the image.
 		/// @return A new CommonProcesses object with the image having reduced noise.
-		CommonProcesses reduceNoise(); 
+		CommonProcesses reduceNoise() &;
+
+		/// @brief Reduces noise in the image of a temporary object.
+		/// @return The temporary object moved out, holding the image having reduced noise.
+		CommonProcesses reduceNoise() &&;
 
 
 		/// @brief Converts the image to grayscale.
-		/// @param img The input image to be converted.
+		/// @param img The input image to be converted (a single channel image is returned unchanged).
 		/// @return The grayscale version of the input image.
 		static Mat RGB2Gray(Mat);
 
+		/// @brief Converts an image to another depth, rescaling between the normalized ranges of the two depths.
+		/// @param img The input image.
+		/// @param depth The target depth.
+		/// @return The converted image (the input itself when the depth already matches).
+		static Mat convertDepth(Mat, int);
+
 		/// @brief Converts the image to grayscale.
 		/// @return A new CommonProcesses object with the image converted to grayscale.
-		CommonProcesses RGB2Gray();
+		CommonProcesses RGB2Gray() &;
+
+		/// @brief Converts the image of a temporary object to grayscale.
+		/// @return The temporary object moved out, holding the grayscale image.
+		CommonProcesses RGB2Gray() &&;
 
 		/// @brief Normalizes the image.
+		/// @param rtype The output depth (CV_8U, CV_16U, CV_16F, CV_32F or CV_64F, default is the precision policy or CV_32F).
 		/// @return A new CommonProcesses object with the normalized image.
-		CommonProcesses normalizeImage();
+		CommonProcesses normalizeImage(int = -1) &;
+
+		/// @brief Normalizes the image of a temporary object, in place when the type is unchanged.
+		/// @param rtype The output depth (CV_8U, CV_16U, CV_16F, CV_32F or CV_64F, default is the precision policy or CV_32F).
+		/// @return The temporary object moved out, holding the normalized image.
+		CommonProcesses normalizeImage(int = -1) &&;
+
+		/// @brief Normalizes the image without changing its type.
+		/// @return A reference to this object holding the normalized image.
+		CommonProcesses& normalizeImageInPlace();
 
 		/// @brief Applies erosion to the image.
 		/// @return A new CommonProcesses object with the image after erosion.
-		CommonProcesses erosion();
+		CommonProcesses erosion() &;
+
+		/// @brief Applies erosion to the image of a temporary object, reusing its buffer.
+		/// @return The temporary object moved out, holding the image after erosion.
+		CommonProcesses erosion() &&;
 
 		/// @brief Applies dilation to the image.
 		/// @return A new CommonProcesses object with the image after dilation.
-		CommonProcesses dilation();
+		CommonProcesses dilation() &;
+
+		/// @brief Applies dilation to the image of a temporary object, reusing its buffer.
+		/// @return The temporary object moved out, holding the image after dilation.
+		CommonProcesses dilation() &&;
 
 		/// @brief Applies opening operation to the image.
 		/// @return A new CommonProcesses object with the image after opening operation.
-		CommonProcesses openImage();
+		CommonProcesses openImage() &;
+
+		/// @brief Applies opening operation to the image of a temporary object, reusing its buffer.
+		/// @return The temporary object moved out, holding the image after opening operation.
+		CommonProcesses openImage() &&;
 
 		/// @brief Applies closing operation to the image.
 		/// @return A new CommonProcesses object with the image after closing operation.
-		CommonProcesses closeImage();
+		CommonProcesses closeImage() &;
+
+		/// @brief Applies closing operation to the image of a temporary object, reusing its buffer.
+		/// @return The temporary object moved out, holding the image after closing operation.
+		CommonProcesses closeImage() &&;
 
 		/// @brief Calculates the histogram of the image.
 		/// @return A matrix representing the histogram of the image.
@@ -174,7 +258,28 @@ class CommonProcesses{
 		CommonProcesses operator/(int);
 
 		/// @brief This function is a destructor of the CommonProcesses class.
-		~CommonProcesses();
+		virtual ~CommonProcesses();
+
+	protected:
+		/// @brief Gets the version of the image data member.
+		/// The version changes whenever the image is replaced or modified in place, so derived classes can tell
+		/// whether results computed from the image are still valid.
+		/// @return The image version.
+		uint64_t getImageVersion();
+
+		/// @brief Gets the image in a depth OpenCV functions can process.
+		/// Half float images are widened to CV_32F, other depths are returned unchanged.
+		/// @return The image ready for computation.
+		Mat computeImage();
+
+		/// @brief Gets the image as an output buffer that can be overwritten in place.
+		/// @return The image when its buffer is owned by this object alone, otherwise an empty Mat.
+		Mat reusableImage();
+
+		/// @brief Converts an operation result to the precision policy of the object.
+		/// @param result The result image of an operation.
+		/// @return The result image stored in the precision policy depth.
+		Mat storeImage(Mat);
 
 	private:
 		/// @brief Identifier for the CommonProcesses object.
@@ -192,6 +297,27 @@ class CommonProcesses{
 		/// @brief File path for the image for the CommonProcesses object.
 		string path;
 
+		/// @brief Version of the image, a new value of nextImageVersion() whenever the image changes.
+		uint64_t imageVersion = 0;
+
+		/// @brief Draws a new image version from a counter shared by all objects.
+		/// @return A version greater than every version drawn before.
+		static uint64_t nextImageVersion();
+
+		/// @brief Pixel precision policy for the CommonProcesses object.
+		PixelPrecision precision = PRECISION_NATIVE;
+
+		/// @brief Creates the result object of an operation, carrying over the precision policy.
+		/// @param id The ID of the new object.
+		/// @param result The result image of the operation.
+		/// @return A new CommonProcesses object holding the stored result.
+		CommonProcesses makeResult(string, Mat);
+
+		/// @brief Gets the image depth of a precision policy.
+		/// @param precision The precision policy.
+		/// @return The image depth, or -1 for PRECISION_NATIVE.
+		static int precisionDepth(PixelPrecision);
+
 		/// @brief Gets the width of the image.
 		/// @return The width of the image.
 		int getWidth();
@@ -204,6 +330,21 @@ class CommonProcesses{
 		/// @return The size of the image.
 		Size getSize();
 
+		/// @brief Gets the upper bound of the normalized range for an image depth.
+		/// @param depth The image depth (CV_8U, CV_16U, CV_16F, CV_32F or CV_64F).
+		/// @return 255 for CV_8U, 65535 for CV_16U and 1 for floating point depths (CV_16F, CV_32F, CV_64F).
+		static double normalizedMax(int);
+
+		/// @brief Gets the structuring element shared by erosion and dilation.
+		/// @return The 50x50 rectangular kernel.
+		static const Mat& morphologyKernel();
+
+		/// @brief Min-max normalizes an image into the normalized range of the given depth.
+		/// @param src The input image.
+		/// @param dst The output image (may be the same as src when the depth is unchanged).
+		/// @param rtype The output depth.
+		static void normalizeMinMax(const Mat&, Mat&, int);
+
 		/// @brief This data member holds the number of objects created.
 		static int count;
 };
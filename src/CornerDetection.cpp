@@ -1,5 +1,32 @@
 // Author: Burak Özdemir
 #include "CornerDetection.h"
+#include "ThresholdKernel.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+    /// @brief Orders corners by descending response, equal responses by row and column.
+    bool stronger(const CornerSet& set, size_t a, size_t b) {
+        if (set.response[a] != set.response[b])
+            return set.response[a] > set.response[b];
+        return set.y[a] != set.y[b] ? set.y[a] < set.y[b] : set.x[a] < set.x[b];
+    }
+
+    /// @brief Keeps the limit strongest corners of a set, in no particular order.
+    void keepStrongest(CornerSet& set, size_t limit) {
+        vector<size_t> order(set.size());
+        iota(order.begin(), order.end(), size_t(0));
+        nth_element(order.begin(), order.begin() + limit, order.end(), [&set](size_t a, size_t b) { return stronger(set, a, b); });
+        CornerSet kept;
+        kept.reserve(limit);
+        for (size_t n = 0; n < limit; n++)
+            kept.push_back(set.x[order[n]], set.y[order[n]], set.response[order[n]]);
+        set = move(kept);
+    }
+}
 
 /// @details This constructor initializes a CornerDetection object with the specified identifier and image, threshold.
 /// Also this constructor sets detect type ( setDetectType("Corner") ).
@@ -23,39 +50,396 @@ CornerDetection::~CornerDetection() {
     cout << "CornerDetection destructor of the " << getID() << " object." << endl;
 }
 
-/// @details This member function utilizes the cornerHarris algorithm to detect corners in the visual image.
-/// Corners are converted to vector<vector<Point>> type. And it sets corners data.
+/// @details This member function utilizes the cornerHarris algorithm (or the detector chosen with setCornerMethod) to detect corners in the visual image.
+/// Corners are stored in a CornerSet together with their normalized response. And it sets corners data.
+/// The set is built once and shared between the corners and the Detection data, it is never copied.
+/// With a cache (see setCache) the result is looked up by image content and parameters first and stored after detection.
+/// cornerHarris accepts CV_8U and CV_32F only, so CV_16U and half float images (see setPrecision) are read as CV_32F (CV_8U for FAST).
+/// Only local maxima of the response are kept (see setSuppressionRadius). All local maxima above the threshold floor are
+/// kept by updateResponse() sorted by response, so the corners above a threshold are found with a binary search and
+/// copied as a prefix: a new threshold (e.g. from the trackbar) costs time proportional to the corners it returns.
+/// Corners are therefore ordered strongest first.
 void CornerDetection::findCorners()
 {
-    Mat img_gray;
-    Mat dst = Mat::zeros(getImage().size(), CV_32FC1);
-
-    vector<vector<Point>> cor;
-    img_gray = RGB2Gray(getImage());
-    cornerHarris(img_gray, dst, blockSize, aperatureSize, k);
-    Mat dst_norm, dst_norm_scaled;
-    normalize(dst, dst_norm, 0, 255, NORM_MINMAX, CV_32FC1, Mat());
-
-    if (thresholdValue < 95) thresholdValue = 95;
-
-    for (int i = 0; i < dst_norm.rows; i++)
-    {
-        for (int j = 0; j < dst_norm.cols; j++)
-        {
-            if ((int)dst_norm.at<float>(i, j) > thresholdValue)
-            {
-                cor.push_back({ Point(j, i) });
+    TRACE_SCOPE("CornerDetection::findCorners");
+    if (thresholdValue < thresholdFloor) thresholdValue = thresholdFloor;
+
+    DetectionCache* cache = getCache();
+    uint64_t key = 0;
+    if (cache) {
+        key = DetectionCache::makeKey(getImage(), cacheParameters());
+        shared_ptr<const CornerSet> cached = cache->findCorners(key);
+        if (cached) {
+            setCorners(cached);
+            setData(corners);
+            return;
+        }
+    }
+
+    updateResponse();
+
+    // (int)response > thresholdValue holds exactly for response >= thresholdValue + 1.
+    float minResponse = float(thresholdValue + 1);
+    size_t count = partition_point(candidates->response.begin(), candidates->response.end(),
+        [minResponse](float response) { return response >= minResponse; }) - candidates->response.begin();
+
+    shared_ptr<CornerSet> cor = make_shared<CornerSet>();
+    cor->x.assign(candidates->x.begin(), candidates->x.begin() + count);
+    cor->y.assign(candidates->y.begin(), candidates->y.begin() + count);
+    cor->response.assign(candidates->response.begin(), candidates->response.begin() + count);
+    if (cache)
+        cache->store(key, getID(), *cor);
+    setCorners(cor);
+    setData(corners, candidates);
+}
+
+/// @details This member function reports the strongest corners above the threshold floor, strongest first; the threshold value
+/// (see findCorners) is not applied.
+/// It needs the response of the whole image, but not the full candidate index: the scan keeps only the strongest maxima
+/// (see collectMaxima), so selecting and sorting them costs time proportional to count, not to the number of maxima.
+/// Without spacing the result is the first count of them. With spacing, candidates are taken in order and a candidate is
+/// skipped if an accepted corner lies within minDistance; accepted corners are kept in a sparse grid with cells of at least
+/// minDistance, so each test looks at 3x3 cells and the walk stops after count corners. The walk starts on the 4 * count
+/// strongest maxima; if they run out first, the maps are scanned again for four times as many, and the walk continues
+/// where it stopped (the strongest maxima are a prefix of any longer list). A full index left by findCorners is used as is.
+/// With a cache (see setCache) the result is looked up by image content, parameters, count and minDistance first.
+void CornerDetection::findStrongestCorners(size_t count, int minDistance)
+{
+    TRACE_SCOPE("CornerDetection::findStrongestCorners");
+
+    DetectionCache* cache = getCache();
+    uint64_t key = 0;
+    if (cache) {
+        ostringstream description;
+        description << cacheParameters() << " strongest=" << count << " minDistance=" << max(minDistance, 0);
+        key = DetectionCache::makeKey(getImage(), description.str());
+        shared_ptr<const CornerSet> cached = cache->findCorners(key);
+        if (cached) {
+            setCorners(cached);
+            setData(corners);
+            return;
+        }
+    }
+
+    shared_ptr<CornerSet> cor = make_shared<CornerSet>();
+    shared_ptr<const CornerSet> source;
+    if (minDistance <= 0) {
+        updateResponse(max(count, size_t(1)));
+        size_t n = min(count, candidates->size());
+        cor->x.assign(candidates->x.begin(), candidates->x.begin() + n);
+        cor->y.assign(candidates->y.begin(), candidates->y.begin() + n);
+        cor->response.assign(candidates->response.begin(), candidates->response.begin() + n);
+        source = candidates;
+    }
+    else {
+        // Four times as many maxima as requested corners, or all of them (0) if that does not fit in a size_t.
+        auto grown = [](size_t limit) { return limit <= numeric_limits<size_t>::max() / 4 ? 4 * limit : 0; };
+        updateResponse(grown(max(count, size_t(1))));
+        size_t n = min(count, candidates->size());
+        cor->reserve(n);
+        int cellSize = max(minDistance, 16);
+        // Only cells holding an accepted corner exist, so the grid grows with the result, not with the image.
+        unordered_map<int64_t, vector<int>> grid;
+        grid.reserve(n);
+        auto cellKey = [](int c, int r) { return (int64_t(r) << 32) | uint32_t(c); };
+        int64_t minDistance2 = int64_t(minDistance) * minDistance;
+        for (size_t i = 0; cor->size() < count; i++) {
+            if (i == candidates->size()) {
+                // The limited list ran out; scan again for more maxima unless it already held all of them.
+                if (candidateLimit == 0)
+                    break;
+                updateResponse(grown(candidateLimit));
+                if (i == candidates->size())
+                    break;
             }
+            int x = candidates->x[i], y = candidates->y[i];
+            int cx = x / cellSize, cy = y / cellSize;
+            bool tooClose = false;
+            for (int r = cy - 1; r <= cy + 1 && !tooClose; r++)
+                for (int c = cx - 1; c <= cx + 1 && !tooClose; c++) {
+                    auto cell = grid.find(cellKey(c, r));
+                    if (cell == grid.end())
+                        continue;
+                    for (int j : cell->second) {
+                        int64_t dx = cor->x[j] - x, dy = cor->y[j] - y;
+                        if (dx * dx + dy * dy < minDistance2) {
+                            tooClose = true;
+                            break;
+                        }
+                    }
+                }
+            if (tooClose)
+                continue;
+            grid[cellKey(cx, cy)].push_back(int(cor->size()));
+            cor->push_back(x, y, candidates->response[i]);
         }
     }
+    if (cache)
+        cache->store(key, getID(), *cor);
     setCorners(cor);
-    setData(getCorners());
+    setData(corners, source);
+}
+
+/// @details This member function recomputes the normalized response of the current detector (see setCornerMethod)
+/// when the image changed (see getImageVersion) or a parameter change cleared it, and the neighborhood maxima when the response or the suppression radius changed.
+/// The maxima are computed for the whole map at once with dilate; without suppression they are the response itself.
+/// A fixed-point response (CORNER_HARRIS_FIXED) is scaled to 0..255 in integer arithmetic instead of normalize.
+/// The candidate index is rebuilt after either of them changed, or when it holds fewer maxima than requested: a limited
+/// index (see findStrongestCorners) answers any smaller limit, a full one every request. Images larger than the tile size
+/// (see setTileSize) are processed tile by tile instead and keep no maps, only the candidate index.
+void CornerDetection::updateResponse(size_t limit) {
+    Mat img_gray;
+    if (!responseValid || responseVersion != getImageVersion()) {
+        TRACE_SCOPE("CornerDetection::cornerResponse");
+        localMaxMap.release();
+        responseMap.release();
+        candidatesValid = false;
+        img_gray = detectorInput();
+
+        tiledResponse = tileSize > 0 && (img_gray.cols > tileSize || img_gray.rows > tileSize);
+        if (!tiledResponse) {
+            Mat dst;
+            detector->computeResponse(img_gray, dst, parameters);
+            if (dst.depth() == CV_32S) {
+                Mat scaled;
+                CornerDetector::scaleTo8Bit(dst, scaled);
+                scaled.convertTo(responseMap, CV_32F);
+            }
+            else {
+                normalize(dst, responseMap, 0, 255, NORM_MINMAX, CV_32FC1, Mat());
+            }
+        }
+        localMaxRadius = -1;
+        responseVersion = getImageVersion();
+        responseValid = true;
+    }
+    if (localMaxRadius != suppressionRadius) {
+        localMaxMap.release();
+        // Tiles compute their maxima while the candidates are built.
+        if (!tiledResponse) {
+            if (suppressionRadius > 0)
+                dilate(responseMap, localMaxMap, getStructuringElement(MORPH_RECT, Size(2 * suppressionRadius + 1, 2 * suppressionRadius + 1)));
+            else
+                localMaxMap = responseMap;
+        }
+        localMaxRadius = suppressionRadius;
+        candidatesValid = false;
+    }
+    if (!candidatesValid || (candidateLimit != 0 && (limit == 0 || limit > candidateLimit))) {
+        if (tiledResponse)
+            buildTiledCandidates(img_gray.empty() ? detectorInput() : img_gray, limit);
+        else
+            buildCandidates(limit);
+        candidatesValid = true;
+    }
+}
+
+/// @details This member function converts the image to the gray depth the current detector accepts.
+Mat CornerDetection::detectorInput() {
+    Mat img_gray = RGB2Gray(computeImage());
+    if (detector->needs8Bit() && img_gray.depth() != CV_8U)
+        img_gray = convertDepth(img_gray, CV_8U);
+    else if (img_gray.depth() != CV_8U && img_gray.depth() != CV_32F)
+        img_gray = convertDepth(img_gray, CV_32F);
+    return img_gray;
+}
+
+/// @details This member function collects the local maxima of the whole response map (or only the limit strongest)
+/// and sorts them into the candidate index.
+void CornerDetection::buildCandidates(size_t limit) {
+    TRACE_SCOPE("CornerDetection::buildCandidates");
+    CornerSet found;
+    size_t total = collectMaxima(responseMap, localMaxMap, Rect(0, 0, responseMap.cols, responseMap.rows), Point(0, 0), suppressionRadius, limit, found);
+    candidateLimit = total > found.size() ? limit : 0;
+    setCandidates(found);
+}
+
+/// @details This member function finds the candidates of a large image with a bounded amount of memory.
+/// A first pass computes the response of each tile only to find the global minimum and maximum, so every tile can
+/// then be normalized exactly like the whole image would be. The second pass computes each tile again, normalizes it,
+/// computes its neighborhood maxima and scans it. Tiles are read with a margin wide enough for the detector window and
+/// the suppression neighborhood, but only pixels owned by the tile (its interior) are reported, so a corner on a seam
+/// is found exactly once and the candidates equal those of the untiled image. A fixed-point response is scaled with the
+/// same integer arithmetic as the untiled one (CornerDetector::scaleTo8Bit over the global range). Its detector chooses
+/// the fixed-point shifts from the data, so before the first pass every tile is given the shifts of the whole image: the
+/// largest sum shift of all tile interiors, then the largest response shift at that sum shift (two more passes, but only
+/// for CORNER_HARRIS_FIXED; float detectors leave the shifts unset).
+/// With a limit, only the limit strongest maxima are kept after each tile.
+void CornerDetection::buildTiledCandidates(const Mat& gray, size_t limit) {
+    TRACE_SCOPE("CornerDetection::buildTiledCandidates");
+    int margin = max(parameters.blockSize / 2 + parameters.aperatureSize / 2 + 1, 4) + suppressionRadius + 1;
+    Rect bounds(0, 0, gray.cols, gray.rows);
+
+    CornerParameters tileParameters = parameters;
+    for (int pass = 0; pass < 2; pass++) {
+        int largest = -1;
+        for (int ty = 0; ty < gray.rows; ty += tileSize) {
+            for (int tx = 0; tx < gray.cols; tx += tileSize) {
+                Rect inner = Rect(tx, ty, tileSize, tileSize) & bounds;
+                Rect outer = Rect(tx - margin, ty - margin, tileSize + 2 * margin, tileSize + 2 * margin) & bounds;
+                CornerParameters measured = tileParameters;
+                // The first pass only needs the sum shift, so a response shift is given to skip choosing it.
+                if (pass == 0)
+                    measured.responseShift = 0;
+                detector->chooseShifts(gray(outer), inner - outer.tl(), measured);
+                largest = max(largest, pass == 0 ? measured.sumShift : measured.responseShift);
+            }
+        }
+        if (largest < 0)
+            break;
+        (pass == 0 ? tileParameters.sumShift : tileParameters.responseShift) = largest;
+    }
+
+    double globalMin = numeric_limits<double>::max(), globalMax = numeric_limits<double>::lowest();
+    Mat raw;
+    for (int ty = 0; ty < gray.rows; ty += tileSize) {
+        for (int tx = 0; tx < gray.cols; tx += tileSize) {
+            Rect inner = Rect(tx, ty, tileSize, tileSize) & bounds;
+            Rect outer = Rect(tx - margin, ty - margin, tileSize + 2 * margin, tileSize + 2 * margin) & bounds;
+            detector->computeResponse(gray(outer), raw, tileParameters);
+            double low, high;
+            minMaxLoc(raw(inner - outer.tl()), &low, &high);
+            globalMin = min(globalMin, low);
+            globalMax = max(globalMax, high);
+        }
+    }
+
+    double scale = globalMax > globalMin ? 255.0 / (globalMax - globalMin) : 0.0;
+    Mat normalized, maxima, scaled;
+    Mat kernel = getStructuringElement(MORPH_RECT, Size(2 * suppressionRadius + 1, 2 * suppressionRadius + 1));
+    CornerSet found;
+    size_t total = 0;
+    for (int ty = 0; ty < gray.rows; ty += tileSize) {
+        for (int tx = 0; tx < gray.cols; tx += tileSize) {
+            Rect inner = Rect(tx, ty, tileSize, tileSize) & bounds;
+            Rect outer = Rect(tx - margin, ty - margin, tileSize + 2 * margin, tileSize + 2 * margin) & bounds;
+            detector->computeResponse(gray(outer), raw, tileParameters);
+            if (raw.depth() == CV_32S) {
+                CornerDetector::scaleTo8Bit(raw, scaled, globalMin, globalMax);
+                scaled.convertTo(normalized, CV_32F);
+            }
+            else {
+                raw.convertTo(normalized, CV_32F, scale, -globalMin * scale);
+            }
+            if (suppressionRadius > 0)
+                dilate(normalized, maxima, kernel);
+            else
+                maxima = normalized;
+            total += collectMaxima(normalized, maxima, inner - outer.tl(), outer.tl(), suppressionRadius, limit, found);
+        }
+    }
+    candidateLimit = total > found.size() ? limit : 0;
+    setCandidates(found);
+}
+
+/// @details This static member function scans an area of a response for local maxima above the threshold floor and appends them,
+/// moved by the origin, in row order.
+/// A pixel passes if its response is at least the neighborhood maximum. A plateau of equal responses would pass as several
+/// pixels, so with suppression a passing pixel is dropped if a pixel before it in row order within the radius (the rows above
+/// and the left part of its row) has the same response; of equal maxima in one neighborhood only the first in row order
+/// is kept. Only the few passing pixels are tested, so the tie break costs no extra pass over the map. It reads the
+/// neighbors outside the area, so the result of a tile equals that of the whole image.
+/// The scan is split into row bands run with parallel_for_; each band appends to its own buffer, and the buffers are
+/// concatenated in band order, so the result does not depend on the thread count. Each row is compacted by
+/// ThresholdKernel, which writes the passing columns straight into the band's x column with SIMD where available.
+/// With a limit, a band that holds twice the limit is cut back to its limit strongest maxima with nth_element, and the
+/// result is cut back once more after the bands are joined, so memory and the later sort are bounded by the limit and
+/// the selection costs time linear in the number of maxima. The kept maxima are then no longer in row order.
+size_t CornerDetection::collectMaxima(const Mat& dst_norm, const Mat& local_max, Rect area, Point origin, int radius, size_t limit, CornerSet& found) {
+    const int bandRows = 32;
+    int bandCount = (area.height + bandRows - 1) / bandRows;
+    vector<CornerSet> bands(bandCount);
+    vector<size_t> bandTotals(bandCount, 0);
+    parallel_for_(Range(0, bandCount), [&](const Range& range) {
+        for (int band = range.start; band < range.end; band++) {
+            CornerSet& out = bands[band];
+            int last = min(area.y + area.height, area.y + (band + 1) * bandRows);
+            for (int i = area.y + band * bandRows; i < last; i++) {
+                const float* response = dst_norm.ptr<float>(i);
+                const float* maximum = local_max.ptr<float>(i);
+                // (int)response > thresholdFloor holds exactly for response >= thresholdFloor + 1.
+                size_t first = out.x.size();
+                out.x.resize(first + area.width + 16);
+                int passed = ThresholdKernel::compact(response + area.x, maximum + area.x, area.width, float(thresholdFloor + 1), out.x.data() + first);
+                size_t kept = first;
+                for (size_t n = first; n < first + passed; n++) {
+                    int x = out.x[n] + area.x;
+                    if (radius > 0 && hasEarlierTie(dst_norm, x, i, radius))
+                        continue;
+                    out.x[kept++] = x + origin.x;
+                    out.response.push_back(response[x]);
+                }
+                out.x.resize(kept);
+                out.y.resize(kept, i + origin.y);
+                bandTotals[band] += kept - first;
+                if (limit > 0 && out.size() / 2 >= limit)
+                    keepStrongest(out, limit);
+            }
+        }
+    });
+
+    size_t total = found.size();
+    for (const CornerSet& band : bands)
+        total += band.size();
+    found.reserve(total);
+    for (const CornerSet& band : bands) {
+        found.x.insert(found.x.end(), band.x.begin(), band.x.end());
+        found.y.insert(found.y.end(), band.y.begin(), band.y.end());
+        found.response.insert(found.response.end(), band.response.begin(), band.response.end());
+    }
+    if (limit > 0 && found.size() > limit)
+        keepStrongest(found, limit);
+    return accumulate(bandTotals.begin(), bandTotals.end(), size_t(0));
+}
+
+/// @details This static member function tests the pixels before (x, y) in row order within the radius, clipped to the map.
+/// It is only called for pixels that are at least their neighborhood maximum, so an equal response is a tie.
+bool CornerDetection::hasEarlierTie(const Mat& response, int x, int y, int radius) {
+    float value = response.at<float>(y, x);
+    int left = max(x - radius, 0), right = min(x + radius, response.cols - 1);
+    for (int r = max(y - radius, 0); r < y; r++) {
+        const float* row = response.ptr<float>(r);
+        for (int c = left; c <= right; c++)
+            if (row[c] >= value)
+                return true;
+    }
+    const float* row = response.ptr<float>(y);
+    for (int c = left; c < x; c++)
+        if (row[c] >= value)
+            return true;
+    return false;
+}
+
+/// @details This member function sorts the found maxima by descending response into a new candidate index; a published
+/// index is never modified, so corner indexes laid out for it stay valid.
+/// Equal responses are ordered by row and column, so the order does not depend on how the image was scanned.
+void CornerDetection::setCandidates(const CornerSet& found) {
+    vector<size_t> order(found.size());
+    iota(order.begin(), order.end(), size_t(0));
+    sort(order.begin(), order.end(), [&found](size_t a, size_t b) { return stronger(found, a, b); });
+
+    shared_ptr<CornerSet> sorted = make_shared<CornerSet>();
+    sorted->reserve(found.size());
+    for (size_t i : order)
+        sorted->push_back(found.x[i], found.y[i], found.response[i]);
+    candidates = sorted;
+}
+
+/// @details This member function lists the detector and all parameters findCorners() depends on.
+/// Every new parameter of findCorners() must be added here, otherwise cached results would be reused wrongly.
+string CornerDetection::cacheParameters() {
+    ostringstream description;
+    description << "Corner " << detector->name() << " threshold=" << thresholdValue << " blockSize=" << parameters.blockSize
+        << " aperatureSize=" << parameters.aperatureSize << " k=" << setprecision(17) << parameters.k
+        << " fast=" << parameters.fastThreshold << " nms=" << suppressionRadius << " tile=" << tileSize;
+    return description.str();
 }
 
 
 /// @details This static function is called when the trackbar value changes.
 /// It is used in conjunction with visualizeFeatures_withTreackbar.
 void CornerDetection::changeTrackbar(int value, void* dataPtr) {
+    TRACE_SCOPE("CornerDetection::changeTrackbar");
     CornerDetection* ptrObject = static_cast<CornerDetection*>(dataPtr);
     ptrObject->thresholdValue = value;
     ptrObject->findCorners();
@@ -64,6 +448,7 @@ void CornerDetection::changeTrackbar(int value, void* dataPtr) {
 }
 
 void CornerDetection::visualizeFeatures_withTreackbar() {
+    TRACE_SCOPE("CornerDetection::visualizeFeatures_withTreackbar");
     namedWindow(getWindowName(), WINDOW_AUTOSIZE);
     createTrackbar("Threshold:", getWindowName(), &thresholdValue, 300, changeTrackbar, this);
     setTrackbarPos("Threshold:", getWindowName(), thresholdValue);
@@ -73,20 +458,84 @@ void CornerDetection::visualizeFeatures_withTreackbar() {
     }
 }
 
+/// @details This member function loads the corners from a feature file and shares them with the corner data.
+bool CornerDetection::loadFeatures(const FeatureFile& file, string id) {
+    if (!Detection::loadFeatures(file, id))
+        return false;
+    setCorners(shareCornerData());
+    return true;
+}
+
 /// @details This function returns the threshold value used in the feature visualization.
 int CornerDetection::getThreshold(){
     return thresholdValue;
 }
 
-/// @details This member function sets the corner data for the visual image using the provided vector of vectors of points.
-void CornerDetection::setCorners(vector<vector<Point>> cor)
+/// @details This member function sets the non-maximum suppression radius; negative values are treated as 0.
+void CornerDetection::setSuppressionRadius(int radius) {
+    suppressionRadius = max(radius, 0);
+}
+
+/// @details This member function returns the non-maximum suppression radius.
+int CornerDetection::getSuppressionRadius() {
+    return suppressionRadius;
+}
+
+/// @details This member function sets the Harris parameters and discards the cached response if any of them changed.
+void CornerDetection::setHarrisParameters(int block, int aperture, double harrisK) {
+    if (block == parameters.blockSize && aperture == parameters.aperatureSize && harrisK == parameters.k)
+        return;
+    parameters.blockSize = block;
+    parameters.aperatureSize = aperture;
+    parameters.k = harrisK;
+    responseValid = false;
+}
+
+/// @details This member function switches the detector and discards the cached response if the method changed.
+void CornerDetection::setCornerMethod(CornerMethod m) {
+    if (m == method)
+        return;
+    method = m;
+    detector = CornerDetector::create(m);
+    responseValid = false;
+}
+
+/// @details This member function returns the corner detection method.
+CornerMethod CornerDetection::getCornerMethod() {
+    return method;
+}
+
+/// @details This member function sets the tile size and discards the cached response if it changed.
+void CornerDetection::setTileSize(int size) {
+    size = max(size, 0);
+    if (size == tileSize)
+        return;
+    tileSize = size;
+    responseValid = false;
+}
+
+/// @details This member function returns the tile size.
+int CornerDetection::getTileSize() {
+    return tileSize;
+}
+
+/// @details This member function sets the FAST threshold and discards the cached response if it changed.
+void CornerDetection::setFastThreshold(int threshold) {
+    if (threshold == parameters.fastThreshold)
+        return;
+    parameters.fastThreshold = threshold;
+    responseValid = false;
+}
+
+/// @details This member function sets the corner data for the visual image. The set is shared, not copied.
+void CornerDetection::setCorners(shared_ptr<const CornerSet> cor)
 {
-    corners = cor;
+    corners = cor ? cor : make_shared<const CornerSet>();
 }
 
-/// @details This member function returns a vector of vectors of points representing the corner data from the visual image.
-vector<vector<Point>> CornerDetection::getCorners(){
-    return corners;
+/// @details This member function returns a read-only view of the corner data from the visual image. Nothing is copied.
+const CornerSet& CornerDetection::getCorners(){
+    return *corners;
 }
 
 /// @details This friend function is used to extract the object's ID and path from the user.
@@ -6,7 +6,9 @@
 #include "opencv2/core.hpp"
 #include "CommonProcesses.h"
 #include "Detection.h"
+#include "CornerDetectors.h"
 #include <vector>
+#include <sstream>
 using namespace cv;
 using namespace std;
 
@@ -37,16 +39,28 @@ public:
 	/// @param path The file path of the image for the CornerDetection object.
 	CornerDetection(string, string, int thr = 200);
 
-	/// @brief Finds corners in the image using the cornerHarris algorithm.
+	/// @brief Finds corners in the image using the cornerHarris algorithm (or the method set with setCornerMethod).
 	void findCorners();
 
+	/// @brief Finds the strongest corners in the image instead of all corners above the threshold.
+	/// The threshold value is ignored; every local maximum above the threshold floor (95) can be reported.
+	/// @param count The maximum number of corners.
+	/// @param minDistance The minimum distance in pixels between two reported corners (default is 0, no spacing).
+	void findStrongestCorners(size_t, int = 0);
+
 	/// @brief Sets the corner data for the image.
-	/// @param corners A vector of vectors of points representing the corner data to be set.
-	void setCorners(vector<vector<Point>>);
+	/// @param corners The corners (positions and Harris responses) to be shared with the object.
+	void setCorners(shared_ptr<const CornerSet>);
+
+	/// @brief Gets the corner data from the image without copying it.
+	/// @return A const reference to the corners.
+	const CornerSet& getCorners();
 
-	/// @brief Gets the corner data from the image.
-	/// @return A vector of vectors of points containing the corner data.
-	vector<vector<Point>> getCorners();
+	/// @brief Loads the corners for the image from an indexed feature file.
+	/// @param file The mapped feature file.
+	/// @param id The ID of the image in the file (default is the ID of the object).
+	/// @return True if the file contains corners for the image.
+	bool loadFeatures(const FeatureFile&, string = "") override;
 
 	/// @brief Visualize features using a trackbar.
 	void visualizeFeatures_withTreackbar();
@@ -60,23 +74,133 @@ public:
 	/// @return The threshold value.
 	int getThreshold();
 
+	/// @brief Sets the non-maximum suppression radius of findCorners.
+	/// A pixel is kept only if no pixel in the (2 * radius + 1) x (2 * radius + 1) square around it has a higher response;
+	/// of equal maxima in one square (a plateau) only the first in row order is kept.
+	/// @param radius The radius in pixels (default is 1, i.e. a 3x3 neighborhood; 0 keeps every pixel above the threshold).
+	void setSuppressionRadius(int);
+
+	/// @brief Gets the non-maximum suppression radius of findCorners.
+	/// @return The radius in pixels.
+	int getSuppressionRadius();
+
+	/// @brief Sets the Harris Corner Detection parameters.
+	/// @param blockSize The size of the block for gradient computation.
+	/// @param aperatureSize The aperture parameter for the Sobel operator.
+	/// @param k The Harris Corner Response parameter.
+	void setHarrisParameters(int, int, double);
+
+	/// @brief Sets the corner detection method. The Harris, Shi-Tomasi and FAST detectors all produce the same
+	/// corner data; threshold, suppression and findStrongestCorners work the same for each of them.
+	/// @param method The method (default is CORNER_HARRIS).
+	void setCornerMethod(CornerMethod);
+
+	/// @brief Gets the corner detection method.
+	/// @return The method.
+	CornerMethod getCornerMethod();
+
+	/// @brief Sets the FAST intensity threshold (used by CORNER_FAST).
+	/// @param threshold The difference between the center and the circle pixels (default is 10).
+	void setFastThreshold(int);
+
+	/// @brief Sets the tile size for very large images. An image wider or higher than the tile size is processed
+	/// tile by tile, so the float response maps never exceed one tile (plus a small margin). The corners are the same
+	/// as without tiling, but the response is computed twice (once to find its range for normalization); CORNER_HARRIS_FIXED
+	/// first computes its window sums twice more, to give every tile the fixed-point shifts of the whole image.
+	/// @param size The side of a tile in pixels (default is 0, no tiling).
+	void setTileSize(int);
+
+	/// @brief Gets the tile size.
+	/// @return The side of a tile in pixels, or 0 if tiling is disabled.
+	int getTileSize();
+
 	/// @brief This function is a destructor of the CornerDetection class.
 	~CornerDetection();
 
 private:
-	/// @brief Detected corners in the image.
-	vector<vector<Point>> corners;
+	/// @brief Describes every parameter that influences findCorners(), for the result cache key.
+	/// @return The parameter string.
+	string cacheParameters();
+
+	/// @brief Computes the normalized Harris response, its neighborhood maxima and the candidate index, unless they are still valid.
+	/// They depend only on the image and the Harris and suppression parameters, not on the threshold.
+	/// @param limit The number of strongest maxima the candidate index must hold (default is 0, all of them).
+	void updateResponse(size_t = 0);
+
+	/// @brief Converts the image to the gray input of the current detector.
+	/// @return The gray image, 8-bit or float.
+	Mat detectorInput();
+
+	/// @brief Collects the local maxima above the threshold floor into the candidate index, strongest first.
+	/// @param limit The number of strongest maxima to keep (0 keeps all of them).
+	void buildCandidates(size_t);
+
+	/// @brief Builds the candidate index tile by tile, without keeping response maps.
+	/// @param gray The grayscale image.
+	/// @param limit The number of strongest maxima to keep (0 keeps all of them).
+	void buildTiledCandidates(const Mat&, size_t);
+
+	/// @brief Appends the local maxima above the threshold floor of an area of a normalized response, in row order.
+	/// @param response The normalized response.
+	/// @param maxima The neighborhood maxima of the response.
+	/// @param area The pixels of the response to scan.
+	/// @param origin The position of the response in the image.
+	/// @param radius The suppression radius the maxima were computed with (0 keeps ties).
+	/// @param limit The number of strongest maxima to keep in found (0 keeps all of them, in row order).
+	/// @param found Receives the maxima.
+	/// @return The number of maxima in the area, including those the limit dropped.
+	static size_t collectMaxima(const Mat&, const Mat&, Rect, Point, int, size_t, CornerSet&);
+
+	/// @brief Checks whether a pixel before the given one in row order, within the radius, has the same or a higher response.
+	/// @param response The normalized response.
+	/// @param x The column of the pixel.
+	/// @param y The row of the pixel.
+	/// @param radius The suppression radius.
+	/// @return True if the pixel is not the first of its neighborhood maximum.
+	static bool hasEarlierTie(const Mat&, int, int, int);
+
+	/// @brief Sorts maxima into the candidate index.
+	/// @param found The maxima.
+	void setCandidates(const CornerSet&);
+
+	/// @brief Lowest threshold findCorners accepts; the candidate index holds every corner above it.
+	static const int thresholdFloor = 95;
+
+	/// @brief Detected corners in the image, shared with the Detection data.
+	shared_ptr<const CornerSet> corners = make_shared<const CornerSet>();
 	/// @brief Threshold value for corner detection.
 	int thresholdValue;
+	/// @brief Non-maximum suppression radius (0 disables suppression).
+	int suppressionRadius = 1;
+
+	/// @brief Normalized Harris response (0..255) of the image, kept across threshold changes.
+	Mat responseMap;
+	/// @brief Image version responseMap was computed from.
+	uint64_t responseVersion = 0;
+	/// @brief Whether the response and candidates are valid (cleared by parameter changes).
+	bool responseValid = false;
+	/// @brief Tile size (0 disables tiling) and whether the current candidates were built tile by tile.
+	int tileSize = 0;
+	bool tiledResponse = false;
+	/// @brief Neighborhood maxima of responseMap, and the suppression radius they were computed with (-1 if none).
+	Mat localMaxMap;
+	int localMaxRadius = -1;
+	/// @brief Local maxima above the threshold floor, sorted by descending response (ties in row order).
+	/// The corners above any threshold are a prefix of this set, which lets the corner index follow a threshold change
+	/// incrementally (see Detection::setData).
+	shared_ptr<const CornerSet> candidates = make_shared<const CornerSet>();
+	/// @brief Whether the candidates match the response and suppression radius, and the number of strongest maxima
+	/// they were limited to (0 if they hold all of them).
+	bool candidatesValid = false;
+	size_t candidateLimit = 0;
 	
-	///@brief Harris Corner Detection parameters.
-	///
-	/// These parameters are used in the Harris Corner Detection algorithm.
+
+	/// @brief Corner detection method and its detector (Harris by default).
+	CornerMethod method = CORNER_HARRIS;
+	shared_ptr<CornerDetector> detector = CornerDetector::create(CORNER_HARRIS);
+
+	///@brief Corner Detection parameters.
 	///
-	///Size of the block for gradient computation.
-	const int blockSize = 2;       
-	///Aperture parameter for the Sobel operator.
-	const int aperatureSize = 3;  
-	///Harris Corner Response parameter.
-	const double k = 0.04;         
+	/// Harris: blockSize = 2, aperatureSize = 3, k = 0.04. FAST: fastThreshold = 10.
+	CornerParameters parameters;
 };
@@ -0,0 +1,188 @@
+// Author: Burak Özdemir
+#include "CornerDetectors.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+	/// @brief Harris corner response.
+	class HarrisDetector : public CornerDetector {
+	public:
+		string name() const override { return "harris"; }
+
+		void computeResponse(const Mat& gray, Mat& response, const CornerParameters& parameters) override {
+			cornerHarris(gray, response, parameters.blockSize, parameters.aperatureSize, parameters.k);
+		}
+	};
+
+	/// @brief Shi-Tomasi response: the smaller eigenvalue of the gradient covariance matrix.
+	/// This is the measure goodFeaturesToTrack ranks corners by; spacing and selection are done by CornerDetection.
+	class ShiTomasiDetector : public CornerDetector {
+	public:
+		string name() const override { return "shi-tomasi"; }
+
+		void computeResponse(const Mat& gray, Mat& response, const CornerParameters& parameters) override {
+			cornerMinEigenVal(gray, response, parameters.blockSize, parameters.aperatureSize);
+		}
+	};
+
+	/// @brief FAST segment test. The keypoints already passed FAST's own non-maximum suppression;
+	/// their scores are written into an otherwise empty response map.
+	class FastDetector : public CornerDetector {
+	public:
+		string name() const override { return "fast"; }
+
+		bool needs8Bit() const override { return true; }
+
+		void computeResponse(const Mat& gray, Mat& response, const CornerParameters& parameters) override {
+			vector<KeyPoint> keypoints;
+			FAST(gray, keypoints, parameters.fastThreshold, true);
+			response = Mat::zeros(gray.size(), CV_32FC1);
+			for (const KeyPoint& point : keypoints)
+				response.at<float>(int(point.pt.y), int(point.pt.x)) = point.response;
+		}
+	};
+
+	/// @brief Harris corner response in integer arithmetic, for 8-bit images.
+	/// The gradients are int16 Sobel derivatives and the windowed products are int32 box sums, like the float pipeline
+	/// of cornerHarris (same kernels and borders) but exact. The sums are then shifted down just enough that the largest
+	/// one stays below 2^21, so det - k * trace^2 fits in int64 with k in 16.16 fixed point, and the response is stored as
+	/// int32 after dropping just enough bits that the largest |response| stays below 2^30. Both shifts are chosen from the
+	/// actual maxima, so a low-contrast image keeps every bit. After scaling to 0..255 the response stays within 2 of the float path.
+	/// Every loop runs over raw rows of integers, so the compiler can vectorize it.
+	/// Apertures above 5 could overflow int16 gradients; they fall back to cornerHarris.
+	class FixedPointHarrisDetector : public CornerDetector {
+	public:
+		string name() const override { return "harris-fixed"; }
+
+		bool needs8Bit() const override { return true; }
+
+		void computeResponse(const Mat& gray, Mat& response, const CornerParameters& parameters) override {
+			if (!isSupported(parameters)) {
+				cornerHarris(gray, response, parameters.blockSize, parameters.aperatureSize, parameters.k);
+				return;
+			}
+			Mat xx, xy, yy;
+			windowSums(gray, parameters, xx, xy, yy);
+			CornerParameters shifts = parameters;
+			shiftsFromSums(xx, xy, yy, Rect(0, 0, gray.cols, gray.rows), shifts);
+			int64_t kFixed = llround(parameters.k * 65536.0);
+
+			response.create(gray.size(), CV_32SC1);
+			for (int i = 0; i < gray.rows; i++) {
+				const int32_t* a = xx.ptr<int32_t>(i);
+				const int32_t* b = xy.ptr<int32_t>(i);
+				const int32_t* c = yy.ptr<int32_t>(i);
+				int32_t* r = response.ptr<int32_t>(i);
+				for (int j = 0; j < gray.cols; j++)
+					r[j] = int32_t(harris(a[j], b[j], c[j], shifts.sumShift, kFixed) >> shifts.responseShift);
+			}
+		}
+
+		void chooseShifts(const Mat& gray, Rect area, CornerParameters& parameters) override {
+			if (!isSupported(parameters) || (parameters.sumShift >= 0 && parameters.responseShift >= 0))
+				return;
+			Mat xx, xy, yy;
+			windowSums(gray, parameters, xx, xy, yy);
+			shiftsFromSums(xx, xy, yy, area, parameters);
+		}
+
+	private:
+		/// @brief Checks that the window sums fit int32 (gradients of apertures 1, 3 and 5 fit int16).
+		static bool isSupported(const CornerParameters& parameters) {
+			// Largest gradient magnitude of an 8-bit image for Sobel apertures 1, 3 and 5.
+			int64_t maxGradient = parameters.aperatureSize == 1 ? 255 : parameters.aperatureSize == 3 ? 4 * 255
+				: parameters.aperatureSize == 5 ? 48 * 255 : 0;
+			int64_t maxSum = maxGradient * maxGradient * parameters.blockSize * parameters.blockSize;
+			return maxGradient != 0 && maxSum < (int64_t(1) << 31);
+		}
+
+		/// @brief Computes the int32 window sums of the gradient products.
+		static void windowSums(const Mat& gray, const CornerParameters& parameters, Mat& xx, Mat& xy, Mat& yy) {
+			Mat dx, dy;
+			Sobel(gray, dx, CV_16S, 1, 0, parameters.aperatureSize);
+			Sobel(gray, dy, CV_16S, 0, 1, parameters.aperatureSize);
+			multiply(dx, dx, xx, 1, CV_32S);
+			multiply(dx, dy, xy, 1, CV_32S);
+			multiply(dy, dy, yy, 1, CV_32S);
+			Size block(parameters.blockSize, parameters.blockSize);
+			boxFilter(xx, xx, CV_32S, block, Point(-1, -1), false);
+			boxFilter(xy, xy, CV_32S, block, Point(-1, -1), false);
+			boxFilter(yy, yy, CV_32S, block, Point(-1, -1), false);
+		}
+
+		/// @brief Harris response of shifted window sums, with k in 16.16 fixed point.
+		static int64_t harris(int64_t a, int64_t b, int64_t c, int shift, int64_t kFixed) {
+			int64_t sa = a >> shift, sb = b >> shift, sc = c >> shift;
+			int64_t trace = sa + sc;
+			return sa * sc - sb * sb - ((kFixed * trace * trace) >> 16);
+		}
+
+		/// @brief Chooses the shifts that are not given from the sums and the response inside an area.
+		static void shiftsFromSums(const Mat& xx, const Mat& xy, const Mat& yy, Rect area, CornerParameters& parameters) {
+			if (parameters.sumShift < 0) {
+				// |xy| <= sqrt(xx * yy), so the largest of xx and yy bounds every sum. Below 2^21, trace^2 < 2^44 and
+				// k * trace^2 < 2^61 in 16.16 fixed point for k <= 1.
+				double largestXX, largestYY;
+				minMaxLoc(xx(area), nullptr, &largestXX);
+				minMaxLoc(yy(area), nullptr, &largestYY);
+				int64_t largestSum = int64_t(max(largestXX, largestYY));
+				parameters.sumShift = 0;
+				while ((largestSum >> parameters.sumShift) >= (int64_t(1) << 21))
+					parameters.sumShift++;
+			}
+			if (parameters.responseShift < 0) {
+				int64_t kFixed = llround(parameters.k * 65536.0);
+				int64_t largest = 0;
+				for (int i = area.y; i < area.y + area.height; i++) {
+					const int32_t* a = xx.ptr<int32_t>(i);
+					const int32_t* b = xy.ptr<int32_t>(i);
+					const int32_t* c = yy.ptr<int32_t>(i);
+					for (int j = area.x; j < area.x + area.width; j++) {
+						int64_t h = harris(a[j], b[j], c[j], parameters.sumShift, kFixed);
+						largest = max(largest, h < 0 ? -h : h);
+					}
+				}
+				// Below 2^30 the response spans less than 2^31, which scaleTo8Bit maps without overflow.
+				parameters.responseShift = 0;
+				while ((largest >> parameters.responseShift) >= (int64_t(1) << 30))
+					parameters.responseShift++;
+			}
+		}
+	};
+}
+
+/// @details This static function finds the range of the response and scales it to 0..255.
+void CornerDetector::scaleTo8Bit(const Mat& response, Mat& scaled) {
+	double low, high;
+	minMaxLoc(response, &low, &high);
+	scaleTo8Bit(response, scaled, low, high);
+}
+
+/// @details This static function maps [low, high] to 0..255 with a 24-bit fixed-point multiplier instead of a division per pixel.
+void CornerDetector::scaleTo8Bit(const Mat& response, Mat& scaled, double low, double high) {
+	int64_t minimum = int64_t(low);
+	int64_t span = int64_t(high) - minimum;
+	// 32 fraction bits keep the rounding of the multiplier below one level for any int32 span. Responses outside the
+	// range (e.g. in the margin of a tile) are clamped to it.
+	int64_t multiplier = span > 0 ? (int64_t(255) << 32) / span : 0;
+	scaled.create(response.size(), CV_8UC1);
+	for (int i = 0; i < response.rows; i++) {
+		const int32_t* r = response.ptr<int32_t>(i);
+		uchar* out = scaled.ptr<uchar>(i);
+		for (int j = 0; j < response.cols; j++)
+			out[j] = uchar((min(max<int64_t>(r[j] - minimum, 0), span) * multiplier) >> 32);
+	}
+}
+
+/// @details This static function returns a new detector of the method.
+unique_ptr<CornerDetector> CornerDetector::create(CornerMethod method) {
+	switch (method) {
+	case CORNER_SHI_TOMASI: return unique_ptr<CornerDetector>(new ShiTomasiDetector());
+	case CORNER_FAST: return unique_ptr<CornerDetector>(new FastDetector());
+	case CORNER_HARRIS_FIXED: return unique_ptr<CornerDetector>(new FixedPointHarrisDetector());
+	default: return unique_ptr<CornerDetector>(new HarrisDetector());
+	}
+}
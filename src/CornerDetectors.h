@@ -0,0 +1,80 @@
+// Author: Burak Özdemir
+#pragma once
+#include <memory>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+using namespace std;
+using namespace cv;
+
+/// @brief Corner detectors supported by CornerDetection.
+enum CornerMethod {
+	CORNER_HARRIS,      ///< Harris corner response (cornerHarris), the default.
+	CORNER_SHI_TOMASI,  ///< Minimum eigenvalue response of Shi and Tomasi, as used by goodFeaturesToTrack (cornerMinEigenVal).
+	CORNER_FAST,        ///< FAST segment test with its own non-maximum suppression; its scores are scattered into a response map.
+	CORNER_HARRIS_FIXED ///< Harris corner response in fixed-point integer arithmetic (int16 gradients, int32 sums).
+};
+
+/// @brief Parameters of the corner detectors. Each detector uses the ones it needs.
+struct CornerParameters {
+	/// @brief Size of the block for gradient computation (Harris, Shi-Tomasi).
+	int blockSize = 2;
+	/// @brief Aperture parameter for the Sobel operator (Harris, Shi-Tomasi).
+	int aperatureSize = 3;
+	/// @brief Harris Corner Response parameter (Harris).
+	double k = 0.04;
+	/// @brief Intensity difference between the center and the circle pixels (FAST).
+	int fastThreshold = 10;
+	/// @brief Bits the fixed-point Harris drops from its window sums and from its response (CORNER_HARRIS_FIXED).
+	/// Negative values (the default) let the detector choose them from the data; the tiles of one image are given the
+	/// shifts of the whole image (see CornerDetector::chooseShifts).
+	int sumShift = -1;
+	int responseShift = -1;
+};
+
+/// @brief CornerDetector is the interface of a corner detection strategy.
+/// Every detector produces a response map, which CornerDetection normalizes, suppresses and thresholds the same way,
+/// so all of them produce the same result container.
+class CornerDetector {
+public:
+	/// @brief Creates the detector of a method.
+	/// @param method The corner detection method.
+	/// @return The detector.
+	static unique_ptr<CornerDetector> create(CornerMethod);
+
+	virtual ~CornerDetector() {}
+
+	/// @brief Gets the name of the detector, used in result cache keys.
+	/// @return The name (e.g. "harris").
+	virtual string name() const = 0;
+
+	/// @brief Checks whether the detector needs an 8-bit image.
+	/// @return True if only CV_8U is accepted; otherwise CV_8U and CV_32F are.
+	virtual bool needs8Bit() const { return false; }
+
+	/// @brief Computes the corner response of a grayscale image.
+	/// @param gray The grayscale image.
+	/// @param response Receives the CV_32FC1 or fixed-point CV_32SC1 response (higher is a stronger corner).
+	/// @param parameters The detector parameters.
+	virtual void computeResponse(const Mat&, Mat&, const CornerParameters&) = 0;
+
+	/// @brief Chooses the fixed-point shifts (see CornerParameters::sumShift) that are not given, from the data inside an area.
+	/// Detectors with a float response leave them unset.
+	/// @param gray The grayscale image.
+	/// @param area The pixels whose sums and response the shifts must hold.
+	/// @param parameters The detector parameters; receives the shifts.
+	virtual void chooseShifts(const Mat&, Rect, CornerParameters&) {}
+
+	/// @brief Scales a fixed-point response to 0..255 in integer arithmetic (like normalize with NORM_MINMAX, rounded down).
+	/// @param response The CV_32SC1 response.
+	/// @param scaled Receives the CV_8UC1 response.
+	static void scaleTo8Bit(const Mat&, Mat&);
+
+	/// @brief Scales a fixed-point response to 0..255 in integer arithmetic, mapping a given range instead of the response's own.
+	/// Tiles of one image use the range of the whole image, so they are scaled exactly like the untiled response.
+	/// @param response The CV_32SC1 response.
+	/// @param scaled Receives the CV_8UC1 response.
+	/// @param low The response mapped to 0.
+	/// @param high The response mapped to 255.
+	static void scaleTo8Bit(const Mat&, Mat&, double, double);
+};
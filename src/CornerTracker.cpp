@@ -0,0 +1,116 @@
+// Author: Burak Özdemir
+#include "CornerTracker.h"
+#include <cmath>
+
+/// @details This constructor creates the keyframe detector; the first frame is always a keyframe.
+CornerTracker::CornerTracker(int threshold, int interval, double ratio)
+	:detector("Tracker", Mat(), threshold), keyframeInterval(max(interval, 1)), minTrackRatio(ratio)
+{
+}
+
+/// @details This function runs the detector on the 8-bit gray frame and restarts every track from its corners.
+void CornerTracker::detect(const Mat& frame) {
+	TRACE_SCOPE("CornerTracker::detect");
+	detector.setImage(frame);
+	if (maxCorners > 0)
+		detector.findStrongestCorners(maxCorners, minDistance);
+	else
+		detector.findCorners();
+	const CornerSet& found = detector.getCorners();
+	points.resize(found.size());
+	for (size_t i = 0; i < found.size(); i++)
+		points[i] = Point2f(float(found.x[i]), float(found.y[i]));
+	responses = found.response;
+	current = detector.shareCornerData();
+	keyframeCorners = found.size();
+	framesSinceKeyframe = 0;
+	keyframe = true;
+	needsKeyframe = false;
+	keyframeCount += 1;
+}
+
+/// @details This function converts the frame to 8-bit gray (rescaling 16-bit and floating point frames) and builds its pyramid once; the pyramid is kept for the
+/// next frame, so every frame is decomposed only once. On a keyframe the corners are detected; otherwise the tracks of
+/// the previous frame are followed with calcOpticalFlowPyrLK and lost or out-of-frame tracks are dropped. The next frame
+/// becomes a keyframe when fewer than minTrackRatio of the keyframe's corners remain or keyframeInterval frames passed.
+shared_ptr<const CornerSet> CornerTracker::track(const Mat& frame) {
+	TRACE_SCOPE("CornerTracker::track");
+	Mat gray;
+	if (frame.channels() == 3)
+		cvtColor(frame, gray, COLOR_BGR2GRAY);
+	else
+		gray = frame;
+	gray = CommonProcesses::convertDepth(gray, CV_8U);
+
+	Size window(flowWindow, flowWindow);
+	vector<Mat> pyramid;
+	buildOpticalFlowPyramid(gray, pyramid, window, flowLevels);
+
+	if (needsKeyframe || previousPyramid.empty()) {
+		detect(gray);
+	}
+	else {
+		keyframe = false;
+		framesSinceKeyframe += 1;
+		vector<Point2f> next;
+		vector<uchar> status;
+		vector<float> error;
+		if (!points.empty())
+			calcOpticalFlowPyrLK(previousPyramid, pyramid, points, next, status, error, window, flowLevels);
+
+		shared_ptr<CornerSet> tracked = make_shared<CornerSet>();
+		tracked->reserve(points.size());
+		size_t kept = 0;
+		for (size_t i = 0; i < points.size(); i++) {
+			int x = int(lround(next[i].x)), y = int(lround(next[i].y));
+			if (!status[i] || x < 0 || y < 0 || x >= gray.cols || y >= gray.rows)
+				continue;
+			points[kept] = next[i];
+			responses[kept] = responses[i];
+			kept += 1;
+			tracked->push_back(x, y, responses[i]);
+		}
+		points.resize(kept);
+		responses.resize(kept);
+		current = tracked;
+	}
+
+	previousPyramid.swap(pyramid);
+	if (points.size() < minTrackRatio * keyframeCorners || framesSinceKeyframe + 1 >= keyframeInterval)
+		needsKeyframe = true;
+	return current;
+}
+
+/// @details This function makes the next frame a keyframe.
+void CornerTracker::reset() {
+	needsKeyframe = true;
+}
+
+/// @details This function limits the corners detected on keyframes.
+void CornerTracker::setMaxCorners(size_t count, int distance) {
+	maxCorners = count;
+	minDistance = distance;
+}
+
+/// @details This function sets the optical flow window and pyramid depth; the next frame is a keyframe,
+/// since the stored pyramid was built with the old parameters.
+void CornerTracker::setFlowParameters(int window, int levels) {
+	flowWindow = max(window, 3);
+	flowLevels = max(levels, 0);
+	needsKeyframe = true;
+}
+
+/// @details This function returns whether the last frame was a keyframe.
+bool CornerTracker::isKeyframe() {
+	return keyframe;
+}
+
+/// @details This function returns the number of keyframes.
+size_t CornerTracker::getKeyframeCount() {
+	return keyframeCount;
+}
+
+/// @details This function returns the keyframe detector.
+CornerDetection& CornerTracker::getDetector() {
+	return detector;
+}
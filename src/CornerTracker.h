@@ -0,0 +1,81 @@
+// Author: Burak Özdemir
+#pragma once
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "CornerDetection.h"
+
+using namespace std;
+using namespace cv;
+
+/// @brief CornerTracker follows corners through the frames of a video instead of detecting them in every frame.
+/// Corners are detected with a CornerDetection on keyframes and propagated to the frames in between with pyramidal
+/// Lucas-Kanade optical flow. A new keyframe is taken when too many tracks were lost or after a fixed number of frames.
+class CornerTracker {
+public:
+	/// @brief Constructor for CornerTracker.
+	/// @param threshold The corner threshold used on keyframes (default is 200).
+	/// @param keyframeInterval The maximum number of frames between keyframes (default is 30).
+	/// @param minTrackRatio The fraction of the keyframe's corners that must still be tracked (default is 0.5).
+	CornerTracker(int = 200, int = 30, double = 0.5);
+
+	/// @brief Processes the next frame of the video.
+	/// @param frame The frame (color or grayscale).
+	/// @return The corners in the frame; tracked corners keep the response they had on their keyframe.
+	shared_ptr<const CornerSet> track(const Mat&);
+
+	/// @brief Forces a keyframe on the next frame, e.g. after a scene cut.
+	void reset();
+
+	/// @brief Sets the maximum number of corners per keyframe; the strongest are kept (see findStrongestCorners).
+	/// @param count The maximum number of corners (default is 0, every corner above the threshold).
+	/// @param minDistance The minimum distance in pixels between two corners (default is 0).
+	void setMaxCorners(size_t, int = 0);
+
+	/// @brief Sets the Lucas-Kanade search window and the number of pyramid levels.
+	/// @param window The search window size (default is 21).
+	/// @param levels The highest pyramid level (default is 3).
+	void setFlowParameters(int, int);
+
+	/// @brief Checks whether the last frame was a keyframe.
+	/// @return True if corners were detected, false if they were tracked.
+	bool isKeyframe();
+
+	/// @brief Gets the number of keyframes since construction.
+	/// @return The number of keyframes.
+	size_t getKeyframeCount();
+
+	/// @brief Gets the detector used on keyframes, e.g. to choose the corner method or the suppression radius.
+	/// @return The detector.
+	CornerDetection& getDetector();
+
+private:
+	/// @brief Detects corners in a frame and starts new tracks.
+	/// @param gray The 8-bit grayscale frame.
+	void detect(const Mat&);
+
+	/// @brief Detector used on keyframes.
+	CornerDetection detector;
+	/// @brief Re-detection policy.
+	int keyframeInterval;
+	double minTrackRatio;
+	size_t maxCorners = 0;
+	int minDistance = 0;
+	/// @brief Optical flow parameters.
+	int flowWindow = 21;
+	int flowLevels = 3;
+
+	/// @brief Image pyramid of the previous frame, reused as the first pyramid of the next frame.
+	vector<Mat> previousPyramid;
+	/// @brief Current track positions and the keyframe response of each track.
+	vector<Point2f> points;
+	vector<float> responses;
+	/// @brief Number of corners on the last keyframe and frames since then.
+	size_t keyframeCorners = 0;
+	int framesSinceKeyframe = 0;
+	bool keyframe = false;
+	bool needsKeyframe = true;
+	size_t keyframeCount = 0;
+	/// @brief Corners of the last frame.
+	shared_ptr<const CornerSet> current = make_shared<const CornerSet>();
+};
@@ -26,15 +26,70 @@ Detection::~Detection(){
     cout << "Detection Class destructor of the " << getID() << " object, Count =" << count_detect << endl;
 }
 
-/// @details This member function returns a vector of vectors of points representing either edge or line data from the image.
-vector<vector<Point>> Detection::getData(){
-    return data;
+/// @details This member function returns a read-only view of the corners found in the image. Nothing is copied.
+/// The view stays valid until the next detection replaces the data; use shareCornerData() to keep the data longer.
+const CornerSet& Detection::getCornerData(){
+    return *cornerData;
 }
 
+/// @details This member function returns a read-only view of the line segments found in the image. Nothing is copied.
+const SegmentSet& Detection::getSegmentData(){
+    return *segmentData;
+}
+
+/// @details This member function returns shared ownership of the corners found in the image.
+/// A detection never modifies a published set, it publishes a new one, so the returned data stays unchanged.
+shared_ptr<const CornerSet> Detection::shareCornerData(){
+    return cornerData;
+}
 
-/// @details This member function sets the edge or line data for the visual image using the provided vector of vectors of points.
-void Detection::setData(vector<vector<Point>> d) {
-    data = d;
+/// @details This member function returns shared ownership of the line segments found in the image.
+shared_ptr<const SegmentSet> Detection::shareSegmentData(){
+    return segmentData;
+}
+
+/// @details This member function (re)builds the corner grid when it was built from another corner set.
+/// Corners cut from a source set (see setData) only update the grid by the corners added or removed since the last cut.
+const CornerGrid& Detection::getCornerIndex() {
+    if (!cornerIndex.isBuiltFrom(cornerData)) {
+        TRACE_SCOPE("Detection::buildCornerIndex");
+        if (cornerSource)
+            cornerIndex.buildPrefix(cornerData, cornerSource);
+        else
+            cornerIndex.build(cornerData);
+    }
+    return cornerIndex;
+}
+
+/// @details This member function (re)builds the segment tree when it was built from another segment set.
+const SegmentTree& Detection::getSegmentIndex() {
+    if (!segmentIndex.isBuiltFrom(segmentData)) {
+        TRACE_SCOPE("Detection::buildSegmentIndex");
+        segmentIndex.build(segmentData);
+    }
+    return segmentIndex;
+}
+
+
+/// @details This member function sets the corner data for the visual image. The set is shared, not copied.
+void Detection::setData(shared_ptr<const CornerSet> d, shared_ptr<const CornerSet> source) {
+    cornerData = d ? d : make_shared<const CornerSet>();
+    cornerSource = d ? source : nullptr;
+}
+
+/// @details This member function sets the line data for the visual image. The set is shared, not copied.
+void Detection::setData(shared_ptr<const SegmentSet> d) {
+    segmentData = d ? d : make_shared<const SegmentSet>();
+}
+
+/// @details This member function sets the cache findCorners()/findLine() consult before detecting.
+void Detection::setCache(DetectionCache* c) {
+    cache = c;
+}
+
+/// @details This member function returns the result cache of the detection.
+DetectionCache* Detection::getCache() {
+    return cache;
 }
 
 string Detection::getWindowName(){
@@ -42,43 +97,133 @@ string Detection::getWindowName(){
 }
 
 /// @details This member function writes the specified features (edge or corner) of the image to a text file.
-void Detection::writeFeatures() {
-
-    ofstream file("./"+detectType + getID() + ".txt");
-    file << "Featues of image" << getID()<<endl;
-
-    for (int i = 0; i < data.size(); ++i) {
-        cout << detectType << i + 1 << " Points:" << endl;
-        file << detectType << i + 1 << " Points:" << endl;
-        for_each(data[i].begin(), data[i].end(), [&](Point value){
-            std::cout << value  << std::endl;
-            file << value << std::endl;
-            });
+/// Corners are written as one point, lines as their start and end points.
+/// The file is written on the calling thread through a large buffer and flushed once; unless quiet, it is echoed to the console.
+void Detection::writeFeatures(bool quiet) {
+    TRACE_SCOPE("Detection::writeFeatures");
+
+    unique_ptr<FeatureWriter> writer = FeatureWriter::create(FEATURES_TEXT);
+    vector<char> buffer(1 << 20);
+    ofstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), streamsize(buffer.size()));
+    file.open("./" + detectType + getID() + writer->extension());
+
+    if (detectType == "Line") {
+        writer->writeSegments(file, getID(), *segmentData);
+        if (!quiet)
+            writer->writeSegments(cout, getID(), *segmentData);
+    }
+    else {
+        writer->writeCorners(file, getID(), *cornerData);
+        if (!quiet)
+            writer->writeCorners(cout, getID(), *cornerData);
     }
 }
 
+/// @details This member function queues the features of the image on the exporter and returns immediately.
+/// The file is named like the text file ("./" + detectType + ID) with the extension of the exporter's format.
+/// The exporter shares the current result set, so a later detection does not change what is written.
+void Detection::writeFeatures(FeatureExporter& exporter) {
+    TRACE_SCOPE("Detection::writeFeatures");
+
+    string path = "./" + detectType + getID() + exporter.extension();
+    if (detectType == "Line")
+        exporter.write(path, getID(), segmentData);
+    else
+        exporter.write(path, getID(), cornerData);
+}
+
+/// @details This member function appends the current features to an indexed feature file, under the ID of the object.
+void Detection::writeFeatures(FeatureFileWriter& writer) {
+    TRACE_SCOPE("Detection::writeFeatures");
+
+    if (detectType == "Line")
+        writer.add(getID(), *segmentData);
+    else
+        writer.add(getID(), *cornerData);
+}
+
+/// @details This member function loads the features of an image from a mapped feature file without recomputing them.
+/// A corner table can only be loaded into a "Corner" detection and a segment table into a "Line" detection;
+/// a Detection without a type takes the type of the table.
+bool Detection::loadFeatures(const FeatureFile& file, string id) {
+    TRACE_SCOPE("Detection::loadFeatures");
+
+    long i = file.isOpen() ? file.find(id.empty() ? getID() : id) : -1;
+    if (i < 0)
+        return false;
+
+    FeatureTable table = file.table(size_t(i));
+    string type = table.kind == FEATURE_CORNERS ? "Corner" : "Line";
+    if (!detectType.empty() && detectType != type)
+        return false;
+    detectType = type;
+
+    if (table.kind == FEATURE_CORNERS)
+        setData(make_shared<const CornerSet>(table.toCorners()));
+    else
+        setData(make_shared<const SegmentSet>(table.toSegments()));
+    return true;
+}
+
 /// @details This member function visualizes the points representing edge and line information on the image. 
 /// The line function is used to show edges, and the circle function is used to show corners.
+/// The feature image is not cloned on every call: only the areas drawn over by the previous call are restored
+/// from the image, so a redraw (e.g. on every trackbar change) costs in proportion to the features, not the image.
 void Detection::visualizeFeatures(){
-    featureImg = getImage().clone();
+    TRACE_SCOPE("Detection::visualizeFeatures");
+    resetFeatureImage();
 
     if (detectType == "Line") {
-        for (vector<Point> pointRow : data) {
-            for (int i = 0; i + 1 < pointRow.size(); i += 2) {
-                const Point& start = pointRow[i];
-                const Point& end = pointRow[i + 1];
-                line(featureImg, Point(start.x, start.y), Point(end.x, end.y), Scalar(255, 0, 0), 2, LINE_AA);
-            }
+        for (size_t i = 0; i < segmentData->size(); ++i) {
+            Point start = segmentData->start(i), end = segmentData->end(i);
+            line(featureImg, start, end, Scalar(255, 0, 0), 2, LINE_AA);
+            markDrawn(Rect(start, end) + Size(1, 1));
         }
     }
     else {
-        for (const auto& point : data) {
-            circle(featureImg, point[0], 20, Scalar(255, 0, 0), 2);
+        for (size_t i = 0; i < cornerData->size(); ++i) {
+            circle(featureImg, cornerData->point(i), 20, Scalar(255, 0, 0), 2);
+            markDrawn(Rect(cornerData->x[i] - 20, cornerData->y[i] - 20, 41, 41));
         }
     }
     imshow(windowName, featureImg);
 }
 
+/// @details This member function returns featureImg to a clean copy of the image.
+/// If the image changed (or featureImg was never built) the image is cloned. Otherwise only the recorded drawing
+/// areas are copied back, or the whole image when the areas add up to more than half of it.
+void Detection::resetFeatureImage() {
+    Mat source = computeImage();
+    if (featureImg.empty() || featureImgVersion != getImageVersion() || featureImg.size() != source.size()
+        || featureImg.type() != source.type()) {
+        featureImg = source.clone();
+        featureImgVersion = getImageVersion();
+        drawnRects.clear();
+        return;
+    }
+
+    double area = 0;
+    for (const Rect& rect : drawnRects)
+        area += rect.area();
+    if (area * 2 > double(source.rows) * source.cols) {
+        source.copyTo(featureImg);
+    }
+    else {
+        for (const Rect& rect : drawnRects)
+            source(rect).copyTo(featureImg(rect));
+    }
+    drawnRects.clear();
+}
+
+/// @details This member function records a drawing area, grown by the pen width (2 px plus 1 px of anti-aliasing).
+void Detection::markDrawn(Rect rect) {
+    const int pen = 3;
+    rect = Rect(rect.x - pen, rect.y - pen, rect.width + 2 * pen, rect.height + 2 * pen) & Rect(0, 0, featureImg.cols, featureImg.rows);
+    if (!rect.empty())
+        drawnRects.push_back(rect);
+}
+
 /// @details This member function returns the detection type data member for the object.
 string Detection::getDetectType(){
     return detectType;
@@ -93,35 +238,44 @@ void Detection::setDetectType(string dtype) {
 
 /// @details This member function calculates the Euclidean distance between two points.
 double Detection::calculateLegth(Point p1, Point p2) {
-    return sqrt(pow(p2.x - p1.x, 2) + pow(p2.y - p1.y, 2));
+    return hypot(double(p2.x - p1.x), double(p2.y - p1.y));
 }
 
 
 /// @details This member function writes information about points or lines onto the image.
-/// The center point for edges and the length for lines (with the Calculate Length function) are printed on the image.
+/// The center point for edges and the length for lines (computed for all lines at once with SegmentStats) are printed on the image.
 void Detection::putFeature() {
-        if (featureImg.empty()) 
-            featureImg = getImage().clone();
+        TRACE_SCOPE("Detection::putFeature");
+        if (featureImg.empty() || featureImgVersion != getImageVersion())
+            resetFeatureImage();
 
+        labels.begin(featureImg.size());
+        Rect area;
         if (detectType == "Line") {
-            for (vector<Point> pointRow : data) {
-                for (size_t i = 0; i + 1 < pointRow.size(); i += 2) {
-                    Point& start = pointRow[i];
-                    Point& end = pointRow[i + 1];
-                    double length = calculateLegth(start,end);
-                    putText(featureImg, to_string(int(round(length))) + "px", Point(start.x, start.y - 1), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 0, 255), 2);
-                }
+            SegmentStats stats(*segmentData);
+            for (size_t i = 0; i < segmentData->size(); ++i) {
+                Point start = segmentData->start(i);
+                string label = to_string(int(round(stats.length[i]))) + "px";
+                if (labels.draw(featureImg, label, Point(start.x, start.y - 1), Scalar(0, 0, 255), &area))
+                    markDrawn(area);
             }
         }
         else {
-            for (vector<Point> point : data) {
-                putText(featureImg, to_string(point[0].x)+","+ to_string(point[0].y), point[0], FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 0, 255), 2);
+            for (size_t i = 0; i < cornerData->size(); ++i) {
+                string label = to_string(cornerData->x[i])+","+ to_string(cornerData->y[i]);
+                if (labels.draw(featureImg, label, cornerData->point(i), Scalar(0, 0, 255), &area))
+                    markDrawn(area);
             }
         }
         imshow(detectType + " " + getID(), featureImg);
         int k = waitKey(0);
 }
 
+/// @details This function forwards the setting to the label renderer of putFeature.
+void Detection::setLabelDeclutter(bool enabled) {
+    labels.setDeclutter(enabled);
+}
+
 /// @details This friend function is used to extract the object's ID and path from the user. 
 istream& operator>>(istream& input, Detection& detectImage) {
     input >> static_cast<CommonProcesses&>(detectImage);
@@ -134,11 +288,19 @@ ostream& operator<<(ostream& output , Detection& detectImage) {
         << endl << "Detect Type is" << detectImage.getDetectType() << endl
         << "Features of image" << detectImage.getID();
 
-        for (int i = 0; i < detectImage.data.size(); ++i) {
-            output << detectImage.getDetectType() << i + 1 << " Points:" << endl;
-            for_each(detectImage.data[i].begin(), detectImage.data[i].end(), [&](Point value) {
-                output << value << endl;
-                });
+        if (detectImage.getDetectType() == "Line") {
+            const SegmentSet& segments = *detectImage.segmentData;
+            for (size_t i = 0; i < segments.size(); ++i) {
+                output << detectImage.getDetectType() << i + 1 << " Points:" << endl
+                    << segments.start(i) << endl << segments.end(i) << endl;
+            }
+        }
+        else {
+            const CornerSet& corners = *detectImage.cornerData;
+            for (size_t i = 0; i < corners.size(); ++i) {
+                output << detectImage.getDetectType() << i + 1 << " Points:" << endl
+                    << corners.point(i) << endl;
+            }
         }
     return output;
 }
@@ -1,7 +1,15 @@
 // Author: Burak Özdemir
 #pragma once
 #include <vector>
+#include <memory>
 #include "CommonProcesses.h"
+#include "Features.h"
+#include "FeatureExporter.h"
+#include "FeatureFile.h"
+#include "DetectionCache.h"
+#include "LabelLayer.h"
+#include "SegmentStats.h"
+#include "SpatialIndex.h"
 #include <fstream>
 #include <algorithm>
 #include <cmath>
@@ -35,18 +43,62 @@ public:
 	Detection(string, string);
 
 	/// @brief Writes edge and line information for the image to a text file.
-	void writeFeatures();
+	/// @param quiet True to write the file only, false to also print the features to the console (default).
+	void writeFeatures(bool = false);
+
+	/// @brief Queues edge and line information for the image on an exporter, which writes it in the background.
+	/// @param exporter The exporter that selects the file format and writes the file.
+	void writeFeatures(FeatureExporter&);
+
+	/// @brief Appends the edge and line information for the image to an indexed feature file.
+	/// @param writer The feature file writer.
+	void writeFeatures(FeatureFileWriter&);
+
+	/// @brief Loads the edge and line information for the image from an indexed feature file.
+	/// @param file The mapped feature file.
+	/// @param id The ID of the image in the file (default is the ID of the object).
+	/// @return True if the file contains features of the matching type for the image.
+	virtual bool loadFeatures(const FeatureFile&, string = "");
 
 	/// @brief Visualizes edge and line information on the image.
 	void visualizeFeatures();
 
-	/// @brief Gets the edge or line data from the image.
-	/// @return A vector of vectors of points containing the edge or line data.
-	vector<vector<Point>> getData();
+	/// @brief Gets the corner data from the image without copying it.
+	/// @return A const reference to the corners.
+	const CornerSet& getCornerData();
+
+	/// @brief Gets the line data from the image without copying it.
+	/// @return A const reference to the line segments.
+	const SegmentSet& getSegmentData();
+
+	/// @brief Gets shared ownership of the corner data.
+	/// @return A shared pointer to the corners, valid after the next detection.
+	shared_ptr<const CornerSet> shareCornerData();
+
+	/// @brief Gets shared ownership of the line data.
+	/// @return A shared pointer to the line segments, valid after the next detection.
+	shared_ptr<const SegmentSet> shareSegmentData();
 
-	/// @brief Sets the edge or line data for the image.
-	/// @param data A vector of vectors of points containing the edge or line data to be set.
-	void setData(vector<vector<Point>>);
+	/// @brief Gets a spatial index of the corner data for rectangle, radius and nearest-neighbor queries.
+	/// The index is built on first use and rebuilt only after the corners changed; after a new threshold it is updated by the
+	/// corners that crossed it (see setData).
+	/// @return The grid index; its queries return indices into getCornerData().
+	const CornerGrid& getCornerIndex();
+
+	/// @brief Gets a spatial index of the line data for rectangle, radius and nearest-neighbor queries.
+	/// The index is built on first use and rebuilt only after the line segments changed.
+	/// @return The tree index; its queries return indices into getSegmentData().
+	const SegmentTree& getSegmentIndex();
+
+	/// @brief Sets the corner data for the image.
+	/// @param data The corners to be shared with the Detection object.
+	/// @param source A set whose first corners are the data, e.g. a candidate list the data was cut from (default is none).
+	/// Later data cut from the same source updates the corner index instead of rebuilding it.
+	void setData(shared_ptr<const CornerSet>, shared_ptr<const CornerSet> = nullptr);
+
+	/// @brief Sets the line data for the image.
+	/// @param data The line segments to be shared with the Detection object.
+	void setData(shared_ptr<const SegmentSet>);
 
 	/// @brief Gets the detection type for the image.
 	/// @return A string representing the detection type.
@@ -64,25 +116,68 @@ public:
 	double calculateLegth(Point,Point);
 
 	/// @brief Writes feature information on the image.
+	/// Labels that would overlap a label already drawn are left out, see setLabelDeclutter.
 	void putFeature();
 
+	/// @brief Enables or disables leaving out overlapping labels in putFeature (enabled by default).
+	/// @param enabled True to leave out overlapping labels, false to draw every label.
+	void setLabelDeclutter(bool);
+
+	/// @brief Sets the result cache used by the detection (nullptr disables caching, the default).
+	/// @param cache The cache; it must outlive its use by the Detection object.
+	void setCache(DetectionCache*);
+
+	/// @brief Gets the result cache used by the detection.
+	/// @return The cache, or nullptr if caching is disabled.
+	DetectionCache* getCache();
+
 	/// @brief Gets the visualization name of the image.
 	/// @return The visualize name of the image.
 	string getWindowName();
 
 	/// @brief This function is a destructor of the Detection class.
-	~Detection();
+	virtual ~Detection();
 
 private:
 	/// @brief Type of detection for the image.
 	string detectType;
 
-	/// @brief Data containing points or lines for detection.
-	vector<vector<Point>> data;
+	/// @brief Corners found by the detection (used when detectType is "Corner"), shared with CornerDetection.
+	shared_ptr<const CornerSet> cornerData = make_shared<const CornerSet>();
+
+	/// @brief Set whose first corners are cornerData, or nullptr if there is none.
+	shared_ptr<const CornerSet> cornerSource;
+
+	/// @brief Line segments found by the detection (used when detectType is "Line"), shared with LineDetection.
+	shared_ptr<const SegmentSet> segmentData = make_shared<const SegmentSet>();
 
-	/// @brief Feature image for visualization.
+	/// @brief Cache for detection results, not owned (nullptr when caching is disabled).
+	DetectionCache* cache = nullptr;
+
+	/// @brief Feature image for visualization. It is allocated once and reused by every redraw.
 	Mat featureImg;
 
+	/// @brief Image version featureImg was built from.
+	uint64_t featureImgVersion = 0;
+
+	/// @brief Bounding boxes of everything drawn into featureImg since it was last clean.
+	vector<Rect> drawnRects;
+
+	/// @brief Makes featureImg a clean copy of the image.
+	/// Only the areas covered by earlier drawings are restored; the image is cloned only when it changed.
+	void resetFeatureImage();
+
+	/// @brief Spatial indexes of the corner and line data, built on demand.
+	CornerGrid cornerIndex;
+	SegmentTree segmentIndex;
+
+	/// @brief Label renderer of putFeature; keeps its glyph atlas between redraws.
+	LabelLayer labels;
+
+	/// @brief Records the bounding box of a drawing in featureImg, so that resetFeatureImage can undo it.
+	/// @param rect The bounding box (clipped to the image).
+	void markDrawn(Rect);
+
 	/// @brief Showing name of the image
 	string windowName;
 
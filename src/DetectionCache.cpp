@@ -0,0 +1,272 @@
+// Author: Burak Özdemir
+#include "DetectionCache.h"
+#include "FeatureFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+	const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+	const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+	const uint64_t prime3 = 0x165667B19E3779F9ULL;
+
+	inline uint64_t rotl(uint64_t x, int r) {
+		return (x << r) | (x >> (64 - r));
+	}
+
+	/// @brief Mixes one 8-byte word into a lane.
+	inline uint64_t round64(uint64_t lane, uint64_t word) {
+		return rotl(lane + word * prime2, 31) * prime1;
+	}
+
+	/// @brief Reads an 8-byte word without alignment requirements.
+	inline uint64_t load64(const unsigned char* p) {
+		uint64_t v;
+		memcpy(&v, p, 8);
+		return v;
+	}
+
+	/// @brief Streaming state of hashBytes. Data may be fed in pieces of any size; the digest equals the hash of
+	/// all pieces concatenated, so rows of a padded image hash like the continuous bytes.
+	class StreamHash {
+	public:
+		StreamHash(uint64_t s) :seed(s), v1(s + prime1 + prime2), v2(s + prime2), v3(s), v4(s - prime1) {}
+
+		/// @brief Feeds bytes. Whole 32-byte blocks go to the four lanes, a remainder waits in the buffer.
+		void update(const void* data, size_t size) {
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+			const unsigned char* end = p + size;
+			total += size;
+			if (buffered > 0) {
+				size_t take = min(size_t(32) - buffered, size);
+				memcpy(buffer + buffered, p, take);
+				buffered += take;
+				p += take;
+				if (buffered < 32)
+					return;
+				consume(buffer);
+				buffered = 0;
+			}
+			for (; p + 32 <= end; p += 32)
+				consume(p);
+			memcpy(buffer, p, size_t(end - p));
+			buffered = size_t(end - p);
+		}
+
+		/// @brief Mixes the lanes and the buffered tail into the final hash.
+		uint64_t digest() const {
+			uint64_t h = total >= 32 ? rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18) : seed + prime3;
+			h += total;
+
+			const unsigned char* p = buffer;
+			const unsigned char* end = buffer + buffered;
+			for (; p + 8 <= end; p += 8)
+				h = rotl(h ^ round64(0, load64(p)), 27) * prime1 + prime3;
+			for (; p < end; ++p)
+				h = rotl(h ^ (*p * prime3), 11) * prime1;
+
+			h ^= h >> 33;
+			h *= prime2;
+			h ^= h >> 29;
+			h *= prime3;
+			h ^= h >> 32;
+			return h;
+		}
+
+	private:
+		/// @brief Mixes one 32-byte block into the lanes.
+		void consume(const unsigned char* p) {
+			v1 = round64(v1, load64(p));
+			v2 = round64(v2, load64(p + 8));
+			v3 = round64(v3, load64(p + 16));
+			v4 = round64(v4, load64(p + 24));
+		}
+
+		uint64_t seed, v1, v2, v3, v4;
+		uint64_t total = 0;
+		unsigned char buffer[32];
+		size_t buffered = 0;
+	};
+}
+
+/// @details This constructor creates the cache directory. The counters start at zero.
+DetectionCache::DetectionCache(string dir, uint64_t limit)
+	:directory(dir), maxBytes(limit), hits(0), misses(0)
+{
+	error_code ec;
+	fs::create_directories(directory, ec);
+}
+
+/// @details This static function hashes memory with four independent multiply-rotate lanes over 32-byte blocks
+/// (in the style of xxHash64), so it runs close to memory bandwidth. It is not a cryptographic hash.
+uint64_t DetectionCache::hashBytes(const void* data, size_t size, uint64_t seed) {
+	StreamHash state(seed);
+	state.update(data, size);
+	return state.digest();
+}
+
+/// @details This static function feeds the rows one after another through one streaming hash state, skipping the
+/// padding between them, so the result equals hashBytes over the rows stored contiguously.
+uint64_t DetectionCache::hashRows(const void* first, size_t rowBytes, size_t step, int rows, uint64_t seed) {
+	const unsigned char* row = static_cast<const unsigned char*>(first);
+	StreamHash state(seed);
+	for (int i = 0; i < rows; i++, row += step)
+		state.update(row, rowBytes);
+	return state.digest();
+}
+
+/// @details This static function hashes the image geometry and type, every pixel row and the parameter string.
+/// The rows go through one streaming hash, so padded or ROI images get the same key as their continuous copy.
+uint64_t DetectionCache::makeKey(const Mat& img, const string& parameters) {
+	int header[3] = { img.rows, img.cols, img.type() };
+	uint64_t h = hashBytes(header, sizeof(header));
+	h = hashRows(img.data, size_t(img.cols) * img.elemSize(), img.step, img.rows, h);
+	return hashBytes(parameters.data(), parameters.size(), h);
+}
+
+/// @details This function returns the entry file of a key: the key as 16 hex digits.
+string DetectionCache::entryPath(uint64_t key) {
+	ostringstream name;
+	name << hex << setw(16) << setfill('0') << key << ".ipaf";
+	return (fs::path(directory) / name.str()).string();
+}
+
+/// @details This function maps the entry of the key and copies its corners. A hit marks the entry as recently used.
+shared_ptr<const CornerSet> DetectionCache::findCorners(uint64_t key) {
+	string path = entryPath(key);
+	FeatureFile file(path);
+	if (file.isOpen() && file.imageCount() == 1 && file.table(0).kind == FEATURE_CORNERS) {
+		hits += 1;
+		error_code ec;
+		fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+		return make_shared<const CornerSet>(file.table(0).toCorners());
+	}
+	misses += 1;
+	return nullptr;
+}
+
+/// @details This function maps the entry of the key and copies its line segments. A hit marks the entry as recently used.
+shared_ptr<const SegmentSet> DetectionCache::findSegments(uint64_t key) {
+	string path = entryPath(key);
+	FeatureFile file(path);
+	if (file.isOpen() && file.imageCount() == 1 && file.table(0).kind == FEATURE_SEGMENTS) {
+		hits += 1;
+		error_code ec;
+		fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+		return make_shared<const SegmentSet>(file.table(0).toSegments());
+	}
+	misses += 1;
+	return nullptr;
+}
+
+/// @details This function writes the corners to a temporary file and renames it into place,
+/// so a concurrent lookup never maps a half written entry. Then the cache is trimmed to its size limit.
+void DetectionCache::store(uint64_t key, string id, const CornerSet& corners) {
+	lock_guard<mutex> guard(lock);
+	string path = entryPath(key);
+	string temp = path + ".tmp";
+	FeatureFileWriter writer(temp);
+	writer.add(id, corners);
+	error_code ec;
+	if (writer.close())
+		fs::rename(temp, path, ec);
+	else
+		fs::remove(temp, ec);
+	evict();
+}
+
+/// @details This function writes the line segments like store() for corners.
+void DetectionCache::store(uint64_t key, string id, const SegmentSet& segments) {
+	lock_guard<mutex> guard(lock);
+	string path = entryPath(key);
+	string temp = path + ".tmp";
+	FeatureFileWriter writer(temp);
+	writer.add(id, segments);
+	error_code ec;
+	if (writer.close())
+		fs::rename(temp, path, ec);
+	else
+		fs::remove(temp, ec);
+	evict();
+}
+
+/// @details This function deletes entries by last use (the modification time, refreshed on every hit), oldest first,
+/// until the total size is within the limit.
+void DetectionCache::evict() {
+	struct EntryInfo {
+		fs::path path;
+		uint64_t size;
+		fs::file_time_type used;
+	};
+	vector<EntryInfo> entries;
+	uint64_t total = 0;
+	error_code ec;
+	for (const auto& item : fs::directory_iterator(directory, ec)) {
+		if (item.path().extension() != ".ipaf")
+			continue;
+		EntryInfo info{ item.path(), item.file_size(ec), item.last_write_time(ec) };
+		total += info.size;
+		entries.push_back(info);
+	}
+	if (total <= maxBytes)
+		return;
+
+	sort(entries.begin(), entries.end(), [](const EntryInfo& a, const EntryInfo& b) { return a.used < b.used; });
+	for (const EntryInfo& entry : entries) {
+		if (total <= maxBytes)
+			break;
+		if (fs::remove(entry.path, ec))
+			total -= entry.size;
+	}
+}
+
+/// @details This function returns the number of hits since construction or the last resetCounters().
+uint64_t DetectionCache::getHits() {
+	return hits;
+}
+
+/// @details This function returns the number of misses since construction or the last resetCounters().
+uint64_t DetectionCache::getMisses() {
+	return misses;
+}
+
+/// @details This function sets both counters to zero.
+void DetectionCache::resetCounters() {
+	hits = 0;
+	misses = 0;
+}
+
+/// @details This function adds up the sizes of all entry files.
+uint64_t DetectionCache::sizeOnDisk() {
+	uint64_t total = 0;
+	error_code ec;
+	for (const auto& item : fs::directory_iterator(directory, ec))
+		if (item.path().extension() == ".ipaf")
+			total += item.file_size(ec);
+	return total;
+}
+
+/// @details This function changes the size limit and evicts entries immediately if needed.
+void DetectionCache::setMaxBytes(uint64_t limit) {
+	lock_guard<mutex> guard(lock);
+	maxBytes = limit;
+	evict();
+}
+
+/// @details This function deletes every entry file of the cache.
+void DetectionCache::clear() {
+	lock_guard<mutex> guard(lock);
+	error_code ec;
+	vector<fs::path> paths;
+	for (const auto& item : fs::directory_iterator(directory, ec))
+		if (item.path().extension() == ".ipaf")
+			paths.push_back(item.path());
+	for (const fs::path& path : paths)
+		fs::remove(path, ec);
+}
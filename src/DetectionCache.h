@@ -0,0 +1,111 @@
+// Author: Burak Özdemir
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <opencv2/opencv.hpp>
+#include "Features.h"
+
+using namespace std;
+using namespace cv;
+
+/// @brief DetectionCache is a content-addressed on-disk cache for detection results.
+/// Entries are keyed by a fast 64-bit hash of the pixel data together with every detector parameter,
+/// so a result is reused whenever the same image is processed with the same settings, regardless of its ID or path.
+/// Each entry is a single-image indexed feature file (see FeatureFile); the least recently used entries are
+/// evicted when the cache grows beyond its size limit.
+class DetectionCache {
+public:
+	/// @brief Constructor for DetectionCache. Creates the cache directory if needed.
+	/// @param directory The directory holding the cache entries.
+	/// @param maxBytes The size limit of the cache in bytes (default is 1 GiB).
+	DetectionCache(string, uint64_t = uint64_t(1) << 30);
+
+	/// @brief Hashes a block of memory.
+	/// @param data The data.
+	/// @param size The size of the data in bytes.
+	/// @param seed The seed to chain hashes.
+	/// @return The 64-bit hash.
+	static uint64_t hashBytes(const void*, size_t, uint64_t = 0);
+
+	/// @brief Hashes rows that may lie apart in memory, like hashBytes over the rows stored one after another.
+	/// @param first The first row.
+	/// @param rowBytes The number of bytes of a row.
+	/// @param step The distance between the starts of two rows in bytes (at least rowBytes).
+	/// @param rows The number of rows.
+	/// @param seed The seed to chain hashes.
+	/// @return The 64-bit hash.
+	static uint64_t hashRows(const void*, size_t, size_t, int, uint64_t = 0);
+
+	/// @brief Computes the cache key of an image and the detector parameters.
+	/// @param img The image (size, type and every pixel are hashed; row padding is not).
+	/// @param parameters A string describing the detector and all of its parameters.
+	/// @return The cache key.
+	static uint64_t makeKey(const Mat&, const string&);
+
+	/// @brief Looks up corners.
+	/// @param key The cache key.
+	/// @return The cached corners, or nullptr on a miss.
+	shared_ptr<const CornerSet> findCorners(uint64_t);
+
+	/// @brief Looks up line segments.
+	/// @param key The cache key.
+	/// @return The cached line segments, or nullptr on a miss.
+	shared_ptr<const SegmentSet> findSegments(uint64_t);
+
+	/// @brief Stores corners.
+	/// @param key The cache key.
+	/// @param id The ID of the image (informational).
+	/// @param corners The corners.
+	void store(uint64_t, string, const CornerSet&);
+
+	/// @brief Stores line segments.
+	/// @param key The cache key.
+	/// @param id The ID of the image (informational).
+	/// @param segments The line segments.
+	void store(uint64_t, string, const SegmentSet&);
+
+	/// @brief Gets the number of lookups that returned a cached result.
+	/// @return The number of hits.
+	uint64_t getHits();
+
+	/// @brief Gets the number of lookups that found no cached result.
+	/// @return The number of misses.
+	uint64_t getMisses();
+
+	/// @brief Resets the hit and miss counters.
+	void resetCounters();
+
+	/// @brief Gets the size of all cache entries on disk.
+	/// @return The size in bytes.
+	uint64_t sizeOnDisk();
+
+	/// @brief Sets the size limit and evicts entries if the cache is larger.
+	/// @param maxBytes The size limit in bytes.
+	void setMaxBytes(uint64_t);
+
+	/// @brief Removes all cache entries.
+	void clear();
+
+private:
+	/// @brief Gets the file path of an entry.
+	/// @param key The cache key.
+	/// @return The path of the entry file.
+	string entryPath(uint64_t);
+
+	/// @brief Removes the least recently used entries until the cache fits its size limit.
+	void evict();
+
+	/// @brief Directory holding the cache entries.
+	string directory;
+	/// @brief Size limit of the cache in bytes.
+	uint64_t maxBytes;
+	/// @brief Number of hits.
+	atomic<uint64_t> hits;
+	/// @brief Number of misses.
+	atomic<uint64_t> misses;
+	/// @brief Serializes writes and evictions.
+	mutex lock;
+};
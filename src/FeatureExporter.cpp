@@ -0,0 +1,254 @@
+// Author: Burak Özdemir
+#include "FeatureExporter.h"
+#include "ByteOrder.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+	/// @brief Writes a 4-byte value (int32 or float) array little-endian.
+	/// On little-endian hosts the array is written with a single call.
+	template <typename T>
+	void writeLittleEndian(ostream& out, const vector<T>& values) {
+		static_assert(sizeof(T) == 4, "feature tables use 4-byte values");
+		if (hostIsLittleEndian()) {
+			out.write(reinterpret_cast<const char*>(values.data()), streamsize(values.size() * sizeof(T)));
+			return;
+		}
+		for (const T& value : values) {
+			char bytes[4];
+			memcpy(bytes, &value, 4);
+			swap(bytes[0], bytes[3]);
+			swap(bytes[1], bytes[2]);
+			out.write(bytes, 4);
+		}
+	}
+
+	/// @brief Writes an unsigned integer little-endian in the given number of bytes.
+	void writeLittleEndian(ostream& out, uint64_t value, int bytes) {
+		for (int i = 0; i < bytes; ++i)
+			out.put(char((value >> (8 * i)) & 0xFF));
+	}
+
+	/// @brief Writes a string as a quoted JSON string.
+	void writeJsonString(ostream& out, const string& s) {
+		out << '"';
+		for (char c : s) {
+			if (c == '"' || c == '\\')
+				out << '\\' << c;
+			else if ((unsigned char)c < 0x20)
+				out << ' ';
+			else
+				out << c;
+		}
+		out << '"';
+	}
+
+	/// @brief Text format, identical to what Detection::writeFeatures() always wrote.
+	class TextFeatureWriter : public FeatureWriter {
+	public:
+		string extension() const override { return ".txt"; }
+
+		void writeCorners(ostream& out, const string& id, const CornerSet& corners) override {
+			out << "Featues of image" << id << '\n';
+			for (size_t i = 0; i < corners.size(); ++i)
+				out << "Corner" << i + 1 << " Points:\n[" << corners.x[i] << ", " << corners.y[i] << "]\n";
+		}
+
+		void writeSegments(ostream& out, const string& id, const SegmentSet& segments) override {
+			out << "Featues of image" << id << '\n';
+			for (size_t i = 0; i < segments.size(); ++i)
+				out << "Line" << i + 1 << " Points:\n[" << segments.x1[i] << ", " << segments.y1[i] << "]\n["
+					<< segments.x2[i] << ", " << segments.y2[i] << "]\n";
+		}
+	};
+
+	/// @brief CSV format: "x,y,response" for corners, "x1,y1,x2,y2" for segments.
+	class CsvFeatureWriter : public FeatureWriter {
+	public:
+		string extension() const override { return ".csv"; }
+
+		void writeCorners(ostream& out, const string&, const CornerSet& corners) override {
+			out << "x,y,response\n";
+			for (size_t i = 0; i < corners.size(); ++i)
+				out << corners.x[i] << ',' << corners.y[i] << ',' << corners.response[i] << '\n';
+		}
+
+		void writeSegments(ostream& out, const string&, const SegmentSet& segments) override {
+			out << "x1,y1,x2,y2\n";
+			for (size_t i = 0; i < segments.size(); ++i)
+				out << segments.x1[i] << ',' << segments.y1[i] << ',' << segments.x2[i] << ',' << segments.y2[i] << '\n';
+		}
+	};
+
+	/// @brief JSON lines format: one object per feature, carrying the image ID.
+	class JsonLinesFeatureWriter : public FeatureWriter {
+	public:
+		string extension() const override { return ".jsonl"; }
+
+		void writeCorners(ostream& out, const string& id, const CornerSet& corners) override {
+			for (size_t i = 0; i < corners.size(); ++i) {
+				out << "{\"image\":";
+				writeJsonString(out, id);
+				out << ",\"x\":" << corners.x[i] << ",\"y\":" << corners.y[i] << ",\"response\":" << corners.response[i] << "}\n";
+			}
+		}
+
+		void writeSegments(ostream& out, const string& id, const SegmentSet& segments) override {
+			for (size_t i = 0; i < segments.size(); ++i) {
+				out << "{\"image\":";
+				writeJsonString(out, id);
+				out << ",\"x1\":" << segments.x1[i] << ",\"y1\":" << segments.y1[i]
+					<< ",\"x2\":" << segments.x2[i] << ",\"y2\":" << segments.y2[i] << "}\n";
+			}
+		}
+	};
+
+	/// @brief Binary format. All values are little-endian:
+	/// magic "IPFB", uint8 version (1), uint8 kind (0 corners, 1 segments), uint16 reserved,
+	/// uint32 ID length, ID bytes, uint64 count, then the tables one after another:
+	/// int32 x[count], int32 y[count], float32 response[count] for corners and
+	/// int32 x1[count], y1[count], x2[count], y2[count] for segments.
+	class BinaryFeatureWriter : public FeatureWriter {
+	public:
+		string extension() const override { return ".bin"; }
+		bool isBinary() const override { return true; }
+
+		void writeCorners(ostream& out, const string& id, const CornerSet& corners) override {
+			writeHeader(out, 0, id, corners.size());
+			writeLittleEndian(out, corners.x);
+			writeLittleEndian(out, corners.y);
+			writeLittleEndian(out, corners.response);
+		}
+
+		void writeSegments(ostream& out, const string& id, const SegmentSet& segments) override {
+			writeHeader(out, 1, id, segments.size());
+			writeLittleEndian(out, segments.x1);
+			writeLittleEndian(out, segments.y1);
+			writeLittleEndian(out, segments.x2);
+			writeLittleEndian(out, segments.y2);
+		}
+
+	private:
+		void writeHeader(ostream& out, int kind, const string& id, size_t count) {
+			out.write("IPFB", 4);
+			writeLittleEndian(out, 1, 1);
+			writeLittleEndian(out, uint64_t(kind), 1);
+			writeLittleEndian(out, 0, 2);
+			writeLittleEndian(out, id.size(), 4);
+			out.write(id.data(), streamsize(id.size()));
+			writeLittleEndian(out, count, 8);
+		}
+	};
+}
+
+/// @details This static function creates the writer of the given format.
+unique_ptr<FeatureWriter> FeatureWriter::create(FeatureFormat format) {
+	switch (format) {
+	case FEATURES_CSV:    return unique_ptr<FeatureWriter>(new CsvFeatureWriter());
+	case FEATURES_JSONL:  return unique_ptr<FeatureWriter>(new JsonLinesFeatureWriter());
+	case FEATURES_BINARY: return unique_ptr<FeatureWriter>(new BinaryFeatureWriter());
+	default:              return unique_ptr<FeatureWriter>(new TextFeatureWriter());
+	}
+}
+
+/// @details This constructor creates the writer of the format and starts the background writer thread.
+FeatureExporter::FeatureExporter(FeatureFormat format, size_t size)
+	:writer(FeatureWriter::create(format)), echoWriter(FeatureWriter::create(FEATURES_TEXT)), bufferSize(size)
+{
+	worker = thread(&FeatureExporter::run, this);
+}
+
+/// @details This destructor lets the writer thread finish the queue and joins it.
+FeatureExporter::~FeatureExporter() {
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_one();
+	worker.join();
+}
+
+/// @details This function sets quiet mode for the files queued afterwards.
+void FeatureExporter::setQuiet(bool q) {
+	lock_guard<mutex> guard(lock);
+	quiet = q;
+}
+
+/// @details This function returns whether the exporter is in quiet mode.
+bool FeatureExporter::isQuiet() {
+	lock_guard<mutex> guard(lock);
+	return quiet;
+}
+
+/// @details This function returns the file extension of the exporter's format.
+string FeatureExporter::extension() {
+	return writer->extension();
+}
+
+/// @details This function queues corners. The shared set is kept alive by the job until it is written.
+void FeatureExporter::write(string path, string id, shared_ptr<const CornerSet> corners) {
+	enqueue(path, [id, corners](FeatureWriter& w, ostream& out) { w.writeCorners(out, id, *corners); });
+}
+
+/// @details This function queues line segments. The shared set is kept alive by the job until it is written.
+void FeatureExporter::write(string path, string id, shared_ptr<const SegmentSet> segments) {
+	enqueue(path, [id, segments](FeatureWriter& w, ostream& out) { w.writeSegments(out, id, *segments); });
+}
+
+/// @details This function adds a job to the queue and wakes the writer thread.
+void FeatureExporter::enqueue(string path, function<void(FeatureWriter&, ostream&)> job) {
+	{
+		lock_guard<mutex> guard(lock);
+		jobs.push_back({ path, !quiet, job });
+	}
+	wake.notify_one();
+}
+
+/// @details This function blocks until the queue is empty and the writer thread is idle, then reports and resets failures.
+bool FeatureExporter::flush() {
+	unique_lock<mutex> guard(lock);
+	idle.wait(guard, [this] { return jobs.empty() && active == 0; });
+	bool ok = !failed;
+	failed = false;
+	return ok;
+}
+
+/// @details This function is the writer thread. Each file gets its own large buffer and is flushed once when closed.
+/// Console echoes use the text format and '\n', so they are not flushed line by line either.
+void FeatureExporter::run() {
+	vector<char> buffer(bufferSize);
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		wake.wait(guard, [this] { return stopping || !jobs.empty(); });
+		if (jobs.empty())
+			break;
+
+		Job job = jobs.front();
+		jobs.pop_front();
+		active += 1;
+		guard.unlock();
+
+		ofstream file;
+		if (!buffer.empty())
+			file.rdbuf()->pubsetbuf(buffer.data(), streamsize(buffer.size()));
+		file.open(job.path, writer->isBinary() ? ios::out | ios::binary : ios::out);
+		bool ok = bool(file);
+		if (ok) {
+			job.write(*writer, file);
+			file.close();
+			ok = !file.fail();
+		}
+		if (job.echo)
+			job.write(*echoWriter, cout);
+
+		guard.lock();
+		active -= 1;
+		if (!ok)
+			failed = true;
+		if (jobs.empty() && active == 0)
+			idle.notify_all();
+	}
+}
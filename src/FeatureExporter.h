@@ -0,0 +1,140 @@
+// Author: Burak Özdemir
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Features.h"
+
+using namespace std;
+
+/// @brief File formats supported by FeatureExporter.
+enum FeatureFormat {
+	FEATURES_TEXT,   ///< Human readable text ("Corner1 Points:" followed by "[x, y]"), the writeFeatures() format.
+	FEATURES_CSV,    ///< One header line and one comma separated line per feature.
+	FEATURES_JSONL,  ///< One JSON object per line and feature.
+	FEATURES_BINARY  ///< Compact little-endian structure-of-arrays tables.
+};
+
+/// @brief FeatureWriter is the interface of a feature file format.
+/// Implementations serialize a whole corner or segment set into an output stream.
+class FeatureWriter {
+public:
+	/// @brief Creates the writer of a format.
+	/// @param format The file format.
+	/// @return The writer.
+	static unique_ptr<FeatureWriter> create(FeatureFormat);
+
+	virtual ~FeatureWriter() {}
+
+	/// @brief Gets the file extension of the format.
+	/// @return The extension including the dot (e.g. ".csv").
+	virtual string extension() const = 0;
+
+	/// @brief Checks whether the format is binary.
+	/// @return True if the stream must be opened in binary mode.
+	virtual bool isBinary() const { return false; }
+
+	/// @brief Writes corners.
+	/// @param out The output stream.
+	/// @param id The ID of the image the corners belong to.
+	/// @param corners The corners.
+	virtual void writeCorners(ostream&, const string&, const CornerSet&) = 0;
+
+	/// @brief Writes line segments.
+	/// @param out The output stream.
+	/// @param id The ID of the image the segments belong to.
+	/// @param segments The line segments.
+	virtual void writeSegments(ostream&, const string&, const SegmentSet&) = 0;
+};
+
+/// @brief FeatureExporter writes detection results to files from a background thread.
+/// Jobs are queued with the shared result sets, so the caller continues immediately and no feature is copied.
+/// Files are written through a large stream buffer and flushed once, at the end of each file.
+class FeatureExporter {
+public:
+	/// @brief Constructor for FeatureExporter. Starts the background writer thread.
+	/// @param format The file format (default is CSV).
+	/// @param bufferSize The size of the write buffer of each file in bytes (default is 1 MiB).
+	FeatureExporter(FeatureFormat = FEATURES_CSV, size_t = 1 << 20);
+
+	/// @brief Destructor for FeatureExporter. Writes all queued jobs and stops the writer thread.
+	~FeatureExporter();
+
+	FeatureExporter(const FeatureExporter&) = delete;
+	FeatureExporter& operator=(const FeatureExporter&) = delete;
+
+	/// @brief Sets quiet mode. When not quiet, every file is also echoed to the console.
+	/// @param quiet True to write files only (default for a new exporter).
+	void setQuiet(bool);
+
+	/// @brief Checks whether the exporter is in quiet mode.
+	/// @return True if files are not echoed to the console.
+	bool isQuiet();
+
+	/// @brief Gets the file extension of the exporter's format.
+	/// @return The extension including the dot.
+	string extension();
+
+	/// @brief Queues corners to be written.
+	/// @param path The output file path.
+	/// @param id The ID of the image the corners belong to.
+	/// @param corners The corners (kept alive until written).
+	void write(string, string, shared_ptr<const CornerSet>);
+
+	/// @brief Queues line segments to be written.
+	/// @param path The output file path.
+	/// @param id The ID of the image the segments belong to.
+	/// @param segments The line segments (kept alive until written).
+	void write(string, string, shared_ptr<const SegmentSet>);
+
+	/// @brief Waits until all queued files are written.
+	/// @return True if every file written since the last flush could be opened and written.
+	bool flush();
+
+private:
+	/// @brief Queues a job for the writer thread.
+	/// @param path The output file path.
+	/// @param job The job; it writes its features with the given writer into the given stream.
+	void enqueue(string, function<void(FeatureWriter&, ostream&)>);
+
+	/// @brief Main loop of the writer thread.
+	void run();
+
+	/// @brief Format writer.
+	unique_ptr<FeatureWriter> writer;
+	/// @brief Text writer used to echo files to the console.
+	unique_ptr<FeatureWriter> echoWriter;
+	/// @brief Size of the write buffer of each file in bytes.
+	size_t bufferSize;
+	/// @brief Whether files are not echoed to the console.
+	bool quiet = true;
+	/// @brief Whether a file could not be written since the last flush.
+	bool failed = false;
+
+	/// @brief A queued file.
+	struct Job {
+		/// @brief Output file path.
+		string path;
+		/// @brief Whether the file is echoed to the console.
+		bool echo;
+		/// @brief Writes the features with the given writer into the given stream.
+		function<void(FeatureWriter&, ostream&)> write;
+	};
+
+	/// @brief Pending jobs.
+	deque<Job> jobs;
+	/// @brief Number of jobs taken by the writer thread but not finished.
+	int active = 0;
+	/// @brief Whether the writer thread should stop once the queue is empty.
+	bool stopping = false;
+	mutex lock;
+	condition_variable wake;
+	condition_variable idle;
+	/// @brief Background writer thread.
+	thread worker;
+};
@@ -0,0 +1,280 @@
+// Author: Burak Özdemir
+#include "FeatureFile.h"
+#include "ByteOrder.h"
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+	/// @brief Appends an unsigned integer little-endian in the given number of bytes.
+	void putLittleEndian(vector<char>& out, uint64_t value, int bytes) {
+		for (int i = 0; i < bytes; ++i)
+			out.push_back(char((value >> (8 * i)) & 0xFF));
+	}
+
+	/// @brief Reads an unsigned little-endian integer of the given number of bytes.
+	uint64_t getLittleEndian(const unsigned char* p, int bytes) {
+		uint64_t value = 0;
+		for (int i = 0; i < bytes; ++i)
+			value |= uint64_t(p[i]) << (8 * i);
+		return value;
+	}
+
+	/// @brief Rounds a byte count up to a multiple of 8.
+	uint64_t align8(uint64_t n) {
+		return (n + 7) & ~uint64_t(7);
+	}
+}
+
+/// @details This constructor creates the file and reserves the header, which close() fills in.
+FeatureFileWriter::FeatureFileWriter(string path)
+	:file(path, ios::out | ios::binary | ios::trunc)
+{
+	vector<char> header(FeatureFileFormat::headerSize, 0);
+	file.write(header.data(), streamsize(header.size()));
+	offset = FeatureFileFormat::headerSize;
+}
+
+/// @details This destructor completes the file, so an unclosed writer still leaves a valid file behind.
+FeatureFileWriter::~FeatureFileWriter() {
+	if (!closed)
+		close();
+}
+
+/// @details This function returns whether the file could be created.
+bool FeatureFileWriter::isOpen() {
+	return file.is_open() && !closed;
+}
+
+/// @details This function writes a column of 4-byte values and pads it to 8 bytes, so every column of the file is 8-byte aligned.
+void FeatureFileWriter::writeColumn(const void* values, size_t n) {
+	const char* bytes = static_cast<const char*>(values);
+	if (hostIsLittleEndian()) {
+		file.write(bytes, streamsize(n * 4));
+	}
+	else {
+		for (size_t i = 0; i < n; ++i) {
+			char v[4] = { bytes[4 * i + 3], bytes[4 * i + 2], bytes[4 * i + 1], bytes[4 * i] };
+			file.write(v, 4);
+		}
+	}
+	uint64_t padded = align8(n * 4);
+	for (uint64_t i = n * 4; i < padded; ++i)
+		file.put(0);
+	offset += padded;
+}
+
+/// @details This function streams the corner columns to the file and remembers their index entry.
+void FeatureFileWriter::add(string id, const CornerSet& corners) {
+	entries.push_back({ id, FEATURE_CORNERS, corners.size(), offset });
+	writeColumn(corners.x.data(), corners.size());
+	writeColumn(corners.y.data(), corners.size());
+	writeColumn(corners.response.data(), corners.size());
+}
+
+/// @details This function streams the segment columns to the file and remembers their index entry.
+void FeatureFileWriter::add(string id, const SegmentSet& segments) {
+	entries.push_back({ id, FEATURE_SEGMENTS, segments.size(), offset });
+	writeColumn(segments.x1.data(), segments.size());
+	writeColumn(segments.y1.data(), segments.size());
+	writeColumn(segments.x2.data(), segments.size());
+	writeColumn(segments.y2.data(), segments.size());
+}
+
+/// @details This function writes the concatenated IDs and the index behind the tables and then fills in the header.
+bool FeatureFileWriter::close() {
+	if (closed)
+		return false;
+	closed = true;
+
+	vector<char> ids;
+	vector<uint64_t> idOffsets;
+	for (const Entry& entry : entries) {
+		idOffsets.push_back(offset + ids.size());
+		ids.insert(ids.end(), entry.id.begin(), entry.id.end());
+	}
+	while (ids.size() % 8)
+		ids.push_back(0);
+	file.write(ids.data(), streamsize(ids.size()));
+	uint64_t indexOffset = offset + ids.size();
+
+	vector<char> index;
+	index.reserve(entries.size() * FeatureFileFormat::indexEntrySize);
+	for (size_t i = 0; i < entries.size(); ++i) {
+		putLittleEndian(index, idOffsets[i], 8);
+		putLittleEndian(index, entries[i].id.size(), 4);
+		putLittleEndian(index, entries[i].kind, 4);
+		putLittleEndian(index, entries[i].count, 8);
+		putLittleEndian(index, entries[i].tableOffset, 8);
+		putLittleEndian(index, 0, 8);
+	}
+	file.write(index.data(), streamsize(index.size()));
+
+	vector<char> header(FeatureFileFormat::magic, FeatureFileFormat::magic + 4);
+	putLittleEndian(header, FeatureFileFormat::version, 4);
+	putLittleEndian(header, entries.size(), 8);
+	putLittleEndian(header, indexOffset, 8);
+	putLittleEndian(header, 0, 8);
+	file.seekp(0);
+	file.write(header.data(), streamsize(header.size()));
+
+	file.close();
+	return !file.fail();
+}
+
+/// @details This function copies the mapped columns into a CornerSet, e.g. to hand them to a Detection.
+CornerSet FeatureTable::toCorners() const {
+	CornerSet corners;
+	if (kind != FEATURE_CORNERS)
+		return corners;
+	corners.x.assign(x, x + count);
+	corners.y.assign(y, y + count);
+	corners.response.assign(response, response + count);
+	return corners;
+}
+
+/// @details This function copies the mapped columns into a SegmentSet.
+SegmentSet FeatureTable::toSegments() const {
+	SegmentSet segments;
+	if (kind != FEATURE_SEGMENTS)
+		return segments;
+	segments.x1.assign(x1, x1 + count);
+	segments.y1.assign(y1, y1 + count);
+	segments.x2.assign(x2, x2 + count);
+	segments.y2.assign(y2, y2 + count);
+	return segments;
+}
+
+/// @details This constructor maps the whole file read-only and validates it. isOpen() reports whether it succeeded.
+FeatureFile::FeatureFile(string path) {
+#ifdef _WIN32
+	HANDLE fileH = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileH == INVALID_HANDLE_VALUE)
+		return;
+	fileHandle = fileH;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileH, &fileSize) || fileSize.QuadPart == 0)
+		return;
+	HANDLE mappingH = CreateFileMappingA(fileH, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingH == nullptr)
+		return;
+	mappingHandle = mappingH;
+	data = static_cast<const unsigned char*>(MapViewOfFile(mappingH, FILE_MAP_READ, 0, 0, 0));
+	size = data ? size_t(fileSize.QuadPart) : 0;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		void* mapped = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped != MAP_FAILED) {
+			data = static_cast<const unsigned char*>(mapped);
+			size = size_t(st.st_size);
+		}
+	}
+	::close(fd);
+#endif
+	if (data && !validate()) {
+		count = 0;
+		index = nullptr;
+	}
+}
+
+/// @details This destructor unmaps the file.
+FeatureFile::~FeatureFile() {
+#ifdef _WIN32
+	if (data)
+		UnmapViewOfFile(data);
+	if (mappingHandle)
+		CloseHandle(mappingHandle);
+	if (fileHandle)
+		CloseHandle(fileHandle);
+#else
+	if (data)
+		munmap(const_cast<unsigned char*>(data), size);
+#endif
+}
+
+/// @details This function checks the magic, the version and that the index and every table lie inside the file.
+bool FeatureFile::validate() {
+	if (!hostIsLittleEndian() || size < FeatureFileFormat::headerSize
+		|| memcmp(data, FeatureFileFormat::magic, 4) != 0
+		|| getLittleEndian(data + 4, 4) != FeatureFileFormat::version)
+		return false;
+
+	uint64_t images = getLittleEndian(data + 8, 8);
+	uint64_t indexOffset = getLittleEndian(data + 16, 8);
+	if (indexOffset > size || images > (size - indexOffset) / FeatureFileFormat::indexEntrySize)
+		return false;
+	index = data + indexOffset;
+	count = size_t(images);
+
+	for (size_t i = 0; i < count; ++i) {
+		const unsigned char* entry = index + i * FeatureFileFormat::indexEntrySize;
+		uint64_t idOffset = getLittleEndian(entry, 8);
+		uint64_t idLength = getLittleEndian(entry + 8, 4);
+		uint64_t kind = getLittleEndian(entry + 12, 4);
+		uint64_t n = getLittleEndian(entry + 16, 8);
+		uint64_t tableOffset = getLittleEndian(entry + 24, 8);
+		uint64_t columns = kind == FEATURE_CORNERS ? 3 : 4;
+		if (kind > FEATURE_SEGMENTS || idOffset > size || idLength > size - idOffset
+			|| tableOffset % 8 != 0 || tableOffset > size || n > (size - tableOffset) / (columns * 4)
+			|| columns * align8(n * 4) > size - tableOffset)
+			return false;
+		lookup[string(reinterpret_cast<const char*>(data + idOffset), size_t(idLength))] = i;
+	}
+	return true;
+}
+
+/// @details This function returns whether the file is mapped and valid.
+bool FeatureFile::isOpen() const {
+	return index != nullptr;
+}
+
+/// @details This function returns the number of images in the file.
+size_t FeatureFile::imageCount() const {
+	return count;
+}
+
+/// @details This function looks the image ID up in the hash table built when the file was opened.
+long FeatureFile::find(const string& id) const {
+	auto it = lookup.find(id);
+	return it == lookup.end() ? -1 : long(it->second);
+}
+
+/// @details This function returns a view of the table of an image. The columns point into the mapping.
+/// An index outside 0 to imageCount() - 1 raises an error instead of reading outside the index.
+FeatureTable FeatureFile::table(size_t i) const {
+	if (i >= count)
+		CV_Error(Error::StsOutOfRange, "FeatureFile::table index out of range");
+	const unsigned char* entry = index + i * FeatureFileFormat::indexEntrySize;
+	FeatureTable t;
+	t.id.assign(reinterpret_cast<const char*>(data + getLittleEndian(entry, 8)), size_t(getLittleEndian(entry + 8, 4)));
+	t.kind = FeatureKind(getLittleEndian(entry + 12, 4));
+	t.count = size_t(getLittleEndian(entry + 16, 8));
+
+	const unsigned char* column = data + getLittleEndian(entry + 24, 8);
+	size_t stride = size_t(align8(t.count * 4));
+	if (t.kind == FEATURE_CORNERS) {
+		t.x = reinterpret_cast<const int32_t*>(column);
+		t.y = reinterpret_cast<const int32_t*>(column + stride);
+		t.response = reinterpret_cast<const float*>(column + 2 * stride);
+	}
+	else {
+		t.x1 = reinterpret_cast<const int32_t*>(column);
+		t.y1 = reinterpret_cast<const int32_t*>(column + stride);
+		t.x2 = reinterpret_cast<const int32_t*>(column + 2 * stride);
+		t.y2 = reinterpret_cast<const int32_t*>(column + 3 * stride);
+	}
+	return t;
+}
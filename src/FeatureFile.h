@@ -0,0 +1,167 @@
+// Author: Burak Özdemir
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Features.h"
+
+using namespace std;
+
+/// @brief Kind of the feature table of an image in a feature file.
+enum FeatureKind {
+	FEATURE_CORNERS = 0,  ///< Corner table: int32 x[], int32 y[], float32 response[].
+	FEATURE_SEGMENTS = 1  ///< Segment table: int32 x1[], int32 y1[], int32 x2[], int32 y2[].
+};
+
+/// @brief Layout of the indexed feature file (all values little-endian, all offsets from the start of the file):
+///
+///     header   "IPAF", uint32 version, uint64 image count, uint64 index offset, uint64 reserved   (32 bytes)
+///     tables   per image, each column 8-byte aligned: the corner or segment columns
+///     ids      the image IDs, concatenated
+///     index    per image: uint64 id offset, uint32 id length, uint32 kind, uint64 count,
+///              uint64 table offset, uint64 reserved                                             (40 bytes)
+///
+/// Columns are stored one after another (structure of arrays), so a mapped file can be read in place.
+namespace FeatureFileFormat {
+	const char magic[4] = { 'I', 'P', 'A', 'F' };
+	const uint32_t version = 1;
+	const size_t headerSize = 32;
+	const size_t indexEntrySize = 40;
+}
+
+/// @brief FeatureFileWriter writes the corner and segment sets of many images into one indexed feature file.
+/// Tables are streamed to disk as they are added; the IDs and the index are written by close().
+class FeatureFileWriter {
+public:
+	/// @brief Constructor for FeatureFileWriter. Creates the file.
+	/// @param path The file path.
+	FeatureFileWriter(string);
+
+	/// @brief Destructor for FeatureFileWriter. Closes the file if close() was not called.
+	~FeatureFileWriter();
+
+	FeatureFileWriter(const FeatureFileWriter&) = delete;
+	FeatureFileWriter& operator=(const FeatureFileWriter&) = delete;
+
+	/// @brief Checks whether the file could be created.
+	/// @return True if the file is open.
+	bool isOpen();
+
+	/// @brief Adds the corners of an image.
+	/// @param id The ID of the image.
+	/// @param corners The corners.
+	void add(string, const CornerSet&);
+
+	/// @brief Adds the line segments of an image.
+	/// @param id The ID of the image.
+	/// @param segments The line segments.
+	void add(string, const SegmentSet&);
+
+	/// @brief Writes the IDs and the index and closes the file.
+	/// @return True if the whole file was written.
+	bool close();
+
+private:
+	/// @brief An index entry kept in memory until close().
+	struct Entry {
+		string id;
+		FeatureKind kind;
+		uint64_t count;
+		uint64_t tableOffset;
+	};
+
+	/// @brief Writes one column, padded to 8 bytes.
+	/// @param data The column values.
+	/// @param count The number of 4-byte values.
+	void writeColumn(const void*, size_t);
+
+	/// @brief Output file.
+	ofstream file;
+	/// @brief Index entries of the images added so far.
+	vector<Entry> entries;
+	/// @brief Current write offset.
+	uint64_t offset = 0;
+	/// @brief Whether close() was called.
+	bool closed = false;
+};
+
+/// @brief FeatureTable is a read-only view of the table of one image inside a mapped feature file.
+/// The column pointers point into the mapping; nothing is parsed or copied.
+struct FeatureTable {
+	/// @brief ID of the image.
+	string id;
+	/// @brief Kind of the table.
+	FeatureKind kind;
+	/// @brief Number of corners or segments.
+	size_t count;
+	/// @brief Columns: x, y, response for corners; x1, y1, x2, y2 for segments (unused columns are nullptr).
+	const int32_t* x = nullptr;
+	const int32_t* y = nullptr;
+	const float* response = nullptr;
+	const int32_t* x1 = nullptr;
+	const int32_t* y1 = nullptr;
+	const int32_t* x2 = nullptr;
+	const int32_t* y2 = nullptr;
+
+	/// @brief Copies the table into a CornerSet.
+	/// @return The corners (empty for a segment table).
+	CornerSet toCorners() const;
+
+	/// @brief Copies the table into a SegmentSet.
+	/// @return The line segments (empty for a corner table).
+	SegmentSet toSegments() const;
+};
+
+/// @brief FeatureFile maps an indexed feature file into memory and gives read-only access to its tables.
+class FeatureFile {
+public:
+	/// @brief Constructor for FeatureFile. Maps and validates the file.
+	/// @param path The file path.
+	FeatureFile(string);
+
+	/// @brief Destructor for FeatureFile. Unmaps the file.
+	~FeatureFile();
+
+	FeatureFile(const FeatureFile&) = delete;
+	FeatureFile& operator=(const FeatureFile&) = delete;
+
+	/// @brief Checks whether the file was mapped and is a valid feature file.
+	/// @return True if the tables can be read.
+	bool isOpen() const;
+
+	/// @brief Gets the number of images in the file.
+	/// @return The number of images.
+	size_t imageCount() const;
+
+	/// @brief Finds the table of an image.
+	/// @param id The ID of the image.
+	/// @return The index of the image, or -1 if the file does not contain it.
+	long find(const string&) const;
+
+	/// @brief Gets the table of an image.
+	/// @param index The index of the image (0 to imageCount() - 1); other values raise a cv::Exception.
+	/// @return A view of the table.
+	FeatureTable table(size_t) const;
+
+private:
+	/// @brief Reads and checks the header and the index, and builds the ID lookup.
+	/// @return True if the file is valid.
+	bool validate();
+
+	/// @brief Start of the mapping.
+	const unsigned char* data = nullptr;
+	/// @brief Size of the mapping in bytes.
+	size_t size = 0;
+	/// @brief Number of images.
+	size_t count = 0;
+	/// @brief Start of the index in the mapping.
+	const unsigned char* index = nullptr;
+	/// @brief Image ID to image index.
+	unordered_map<string, size_t> lookup;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,90 @@
+// Author: Burak Özdemir
+#pragma once
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+using namespace std;
+using namespace cv;
+
+/// @brief CornerSet stores detected corners as a structure of arrays.
+/// Coordinates and responses live in three contiguous arrays, so a corner costs no allocation of its own
+/// and all corners can be iterated linearly.
+struct CornerSet {
+	/// @brief Column (x coordinate) of each corner.
+	vector<int> x;
+	/// @brief Row (y coordinate) of each corner.
+	vector<int> y;
+	/// @brief Detector response of each corner.
+	vector<float> response;
+
+	/// @brief Gets the number of corners.
+	/// @return The number of corners.
+	size_t size() const { return x.size(); }
+
+	/// @brief Checks whether the set holds no corners.
+	/// @return True if there are no corners.
+	bool empty() const { return x.empty(); }
+
+	/// @brief Removes all corners, keeping the allocated capacity.
+	void clear() { x.clear(); y.clear(); response.clear(); }
+
+	/// @brief Reserves capacity for the given number of corners.
+	/// @param n The number of corners.
+	void reserve(size_t n) { x.reserve(n); y.reserve(n); response.reserve(n); }
+
+	/// @brief Appends a corner.
+	/// @param cx The column of the corner.
+	/// @param cy The row of the corner.
+	/// @param r The detector response of the corner.
+	void push_back(int cx, int cy, float r) { x.push_back(cx); y.push_back(cy); response.push_back(r); }
+
+	/// @brief Gets the position of a corner.
+	/// @param i The index of the corner.
+	/// @return The corner as a Point.
+	Point point(size_t i) const { return Point(x[i], y[i]); }
+};
+
+/// @brief SegmentSet stores detected line segments as a structure of arrays.
+/// The start (x1, y1) and end (x2, y2) coordinates of all segments live in four contiguous arrays.
+struct SegmentSet {
+	/// @brief Start column of each segment.
+	vector<int> x1;
+	/// @brief Start row of each segment.
+	vector<int> y1;
+	/// @brief End column of each segment.
+	vector<int> x2;
+	/// @brief End row of each segment.
+	vector<int> y2;
+
+	/// @brief Gets the number of segments.
+	/// @return The number of segments.
+	size_t size() const { return x1.size(); }
+
+	/// @brief Checks whether the set holds no segments.
+	/// @return True if there are no segments.
+	bool empty() const { return x1.empty(); }
+
+	/// @brief Removes all segments, keeping the allocated capacity.
+	void clear() { x1.clear(); y1.clear(); x2.clear(); y2.clear(); }
+
+	/// @brief Reserves capacity for the given number of segments.
+	/// @param n The number of segments.
+	void reserve(size_t n) { x1.reserve(n); y1.reserve(n); x2.reserve(n); y2.reserve(n); }
+
+	/// @brief Appends a segment.
+	/// @param segment The segment as (x1, y1, x2, y2), as returned by HoughLinesP.
+	void push_back(const Vec4i& segment) {
+		x1.push_back(segment[0]); y1.push_back(segment[1]);
+		x2.push_back(segment[2]); y2.push_back(segment[3]);
+	}
+
+	/// @brief Gets the start point of a segment.
+	/// @param i The index of the segment.
+	/// @return The start point.
+	Point start(size_t i) const { return Point(x1[i], y1[i]); }
+
+	/// @brief Gets the end point of a segment.
+	/// @param i The index of the segment.
+	/// @return The end point.
+	Point end(size_t i) const { return Point(x2[i], y2[i]); }
+};
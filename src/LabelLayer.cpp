@@ -0,0 +1,111 @@
+// Author: Burak Özdemir
+#include "LabelLayer.h"
+#include <algorithm>
+
+/// @details This constructor measures the font once; glyphs are rasterized lazily. The occupancy grid cell is
+/// as high as a line of text, so a label covers only a few cells.
+LabelLayer::LabelLayer(int face, double scale, int thick)
+	:fontFace(face), fontScale(scale), thickness(thick), glyphs(128)
+{
+	int baseline = 0;
+	Size size = getTextSize("0", fontFace, fontScale, thickness, &baseline);
+	ascent = size.height + thickness;
+	descent = baseline + thickness;
+	cellSize = max(8, ascent + descent);
+}
+
+/// @details This function clears the occupancy grid for a canvas of the given size.
+void LabelLayer::begin(Size canvas) {
+	gridCols = canvas.width / cellSize + 1;
+	gridRows = canvas.height / cellSize + 1;
+	occupied.assign(size_t(gridCols) * gridRows, 0);
+	drawnCount = 0;
+	suppressedCount = 0;
+}
+
+/// @details This function rasterizes a character with putText into its own mask the first time it is needed.
+const LabelLayer::Glyph& LabelLayer::glyph(char c) {
+	unsigned char index = (unsigned char)c < 128 ? (unsigned char)c : (unsigned char)'?';
+	Glyph& g = glyphs[index];
+	if (!g.ready) {
+		string text(1, char(index));
+		int baseline = 0;
+		Size size = getTextSize(text, fontFace, fontScale, thickness, &baseline);
+		g.originCol = thickness;
+		g.baselineRow = ascent;
+		g.mask = Mat::zeros(ascent + descent, size.width + 2 * thickness, CV_8UC1);
+		putText(g.mask, text, Point(g.originCol, g.baselineRow), fontFace, fontScale, Scalar(255), thickness);
+		g.advance = size.width;
+		g.ready = true;
+	}
+	return g;
+}
+
+/// @details This function adds up the glyph advances of the label.
+Rect LabelLayer::measure(const string& text, Point origin) {
+	int width = 0;
+	for (char c : text)
+		width += glyph(c).advance;
+	return Rect(origin.x, origin.y - ascent, width + thickness, ascent + descent);
+}
+
+/// @details This function first checks the grid cell of the label origin (one lookup rejects most labels in dense
+/// clusters), then every cell the label covers. A visible label marks its cells and is composed from glyph masks
+/// with masked setTo, clipped to the canvas.
+bool LabelLayer::draw(Mat& canvas, const string& text, Point origin, const Scalar& color, Rect* area) {
+	Rect bounds = Rect(0, 0, canvas.cols, canvas.rows);
+	Rect rect = measure(text, origin) & bounds;
+	if (rect.empty())
+		return false;
+
+	if (declutter && !occupied.empty()) {
+		int c0 = rect.x / cellSize, c1 = (rect.x + rect.width - 1) / cellSize;
+		int r0 = rect.y / cellSize, r1 = (rect.y + rect.height - 1) / cellSize;
+		c1 = min(c1, gridCols - 1);
+		r1 = min(r1, gridRows - 1);
+		if (occupied[size_t(r0) * gridCols + c0]) {
+			suppressedCount += 1;
+			return false;
+		}
+		for (int r = r0; r <= r1; r++)
+			for (int c = c0; c <= c1; c++)
+				if (occupied[size_t(r) * gridCols + c]) {
+					suppressedCount += 1;
+					return false;
+				}
+		for (int r = r0; r <= r1; r++)
+			fill(occupied.begin() + size_t(r) * gridCols + c0, occupied.begin() + size_t(r) * gridCols + c1 + 1, 1);
+	}
+
+	int penX = origin.x;
+	for (char c : text) {
+		const Glyph& g = glyph(c);
+		Rect target(penX - g.originCol, origin.y - g.baselineRow, g.mask.cols, g.mask.rows);
+		Rect visible = target & bounds;
+		if (!visible.empty()) {
+			Rect source(visible.x - target.x, visible.y - target.y, visible.width, visible.height);
+			canvas(visible).setTo(color, g.mask(source));
+		}
+		penX += g.advance;
+	}
+
+	drawnCount += 1;
+	if (area)
+		*area = rect;
+	return true;
+}
+
+/// @details This function turns suppression of overlapping labels on or off.
+void LabelLayer::setDeclutter(bool enabled) {
+	declutter = enabled;
+}
+
+/// @details This function returns the number of labels drawn since begin().
+size_t LabelLayer::getDrawnCount() {
+	return drawnCount;
+}
+
+/// @details This function returns the number of labels suppressed since begin().
+size_t LabelLayer::getSuppressedCount() {
+	return suppressedCount;
+}
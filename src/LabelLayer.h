@@ -0,0 +1,95 @@
+// Author: Burak Özdemir
+#pragma once
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+using namespace std;
+using namespace cv;
+
+/// @brief LabelLayer draws many small text labels quickly and without clutter.
+/// Every character is rasterized once into a glyph mask (a small glyph atlas) and labels are composed by
+/// blitting these masks, instead of running putText for every label. Labels whose area overlaps an already drawn
+/// label are suppressed with a grid occupancy check, so the drawing cost follows the number of visible labels.
+class LabelLayer {
+public:
+	/// @brief Constructor for LabelLayer.
+	/// @param fontFace The Hershey font (default is FONT_HERSHEY_SIMPLEX).
+	/// @param fontScale The font scale (default is 0.5).
+	/// @param thickness The stroke thickness (default is 2).
+	LabelLayer(int = FONT_HERSHEY_SIMPLEX, double = 0.5, int = 2);
+
+	/// @brief Starts a new frame of labels: clears the occupancy grid and the counters.
+	/// @param canvas The size of the image the labels are drawn on.
+	void begin(Size);
+
+	/// @brief Draws a label unless it overlaps a label drawn before in the same frame.
+	/// @param canvas The image to draw on.
+	/// @param text The label text (printable ASCII).
+	/// @param origin The bottom-left corner of the text, as for putText.
+	/// @param color The text color.
+	/// @param area Receives the area of the drawn label (optional).
+	/// @return True if the label was drawn, false if it was suppressed or lies outside the canvas.
+	bool draw(Mat&, const string&, Point, const Scalar&, Rect* = nullptr);
+
+	/// @brief Gets the area a label would cover.
+	/// @param text The label text.
+	/// @param origin The bottom-left corner of the text.
+	/// @return The bounding box of the label.
+	Rect measure(const string&, Point);
+
+	/// @brief Enables or disables suppression of overlapping labels (enabled by default).
+	/// @param enabled True to suppress overlapping labels.
+	void setDeclutter(bool);
+
+	/// @brief Gets the number of labels drawn since begin().
+	/// @return The number of drawn labels.
+	size_t getDrawnCount();
+
+	/// @brief Gets the number of labels suppressed since begin().
+	/// @return The number of suppressed labels.
+	size_t getSuppressedCount();
+
+private:
+	/// @brief A rasterized character.
+	struct Glyph {
+		/// @brief Character mask (255 where the character is drawn).
+		Mat mask;
+		/// @brief Horizontal advance to the next character.
+		int advance = 0;
+		/// @brief Row of the baseline inside the mask.
+		int baselineRow = 0;
+		/// @brief Column of the pen position inside the mask.
+		int originCol = 0;
+		/// @brief Whether the glyph has been rasterized.
+		bool ready = false;
+	};
+
+	/// @brief Gets the glyph of a character, rasterizing it on first use.
+	/// @param c The character.
+	/// @return The glyph.
+	const Glyph& glyph(char);
+
+	/// @brief Font parameters.
+	int fontFace;
+	double fontScale;
+	int thickness;
+	/// @brief Height above and depth below the baseline of the font.
+	int ascent;
+	int descent;
+
+	/// @brief Glyph atlas for the printable ASCII characters.
+	vector<Glyph> glyphs;
+
+	/// @brief Whether overlapping labels are suppressed.
+	bool declutter = true;
+	/// @brief Occupancy grid (one byte per cell) and its geometry.
+	vector<unsigned char> occupied;
+	int cellSize;
+	int gridCols = 0;
+	int gridRows = 0;
+
+	/// @brief Counters since begin().
+	size_t drawnCount = 0;
+	size_t suppressedCount = 0;
+};
@@ -26,14 +26,28 @@ LineDetection::~LineDetection(){
 }
 
 
-/// @details This member function sets the line data for the visual image using the provided vector of vectors of points.
-void LineDetection::setLine(vector<vector<Point>> l) {
-	lines = l;
+/// @details This member function sets the line data for the visual image. The set is shared, not copied.
+void LineDetection::setLine(shared_ptr<const SegmentSet> l) {
+	lines = l ? l : make_shared<const SegmentSet>();
 }
 
-/// @details This member function returns a vector of vectors of points representing the line data from the visual image.
-vector<vector<Point>> LineDetection::getLine() {
-	return lines;
+/// @details This member function returns a read-only view of the line data from the visual image. Nothing is copied.
+const SegmentSet& LineDetection::getLine() {
+	return *lines;
+}
+
+/// @details This member function computes the statistics of the detected lines with SegmentStats.
+SegmentStats LineDetection::getLineStats(int bins) {
+	TRACE_SCOPE("LineDetection::getLineStats");
+	return SegmentStats(*lines, bins);
+}
+
+/// @details This member function loads the lines from a feature file and shares them with the line data.
+bool LineDetection::loadFeatures(const FeatureFile& file, string id) {
+	if (!Detection::loadFeatures(file, id))
+		return false;
+	setLine(shareSegmentData());
+	return true;
 }
 
 /// @details This member function returns the reference to the minimum threshold value used for line detection in LineDetection.
@@ -48,32 +62,172 @@ int LineDetection::getMaxThr() {
 }
 
 /// @details This member function utilizes the Canny edge detection and HoughLines algorithms to detect lines in the image. 
-/// Lines are converted to vector<vector<Point>> type (made to be the same type as corners). And it sets lines data.
+/// Lines are stored in a SegmentSet (one x1, y1, x2, y2 entry per segment). And it sets lines data.
+/// The set is shared between the lines and the Detection data, it is never copied.
+/// With a cache (see setCache) the result is looked up by image content and parameters first and stored after detection.
+/// Canny works on 8-bit images only, so the gray image is converted to CV_8U whatever the precision policy is.
+/// The blurred image and its gradients are kept by updateGradients(), so a new threshold (e.g. from the trackbar) only
+/// runs the hysteresis of Canny on the stored gradients and HoughLinesP.
+/// The Hough transform uses the parameters and budget set with setHoughParameters and setHoughBudget. With a segment
+/// limit or a deadline the edge map is processed in bands of rows and processing stops after the band that reaches the
+/// limit; stoppedEarly() reports it. The deadline is only checked between bands, so a band that has started always
+/// finishes and findLine() can overrun the deadline by the time of one band. Results cut short by the deadline depend on
+/// timing and are not cached; on a cache hit the segment limit counts as reached when the result holds maxSegments segments.
 void LineDetection::findLine() {
-	Mat img_gray;
-	vector<vector<Point>> lines;
+	TRACE_SCOPE("LineDetection::findLine");
+	int64_t start = getTickCount();
+	houghStoppedEarly = false;
+	DetectionCache* cache = getCache();
+	uint64_t key = 0;
+	if (cache) {
+		key = DetectionCache::makeKey(getImage(), cacheParameters());
+		shared_ptr<const SegmentSet> cached = cache->findSegments(key);
+		if (cached) {
+			houghStoppedEarly = houghBudget.maxSegments > 0 && cached->size() >= houghBudget.maxSegments;
+			setLine(cached);
+			setData(lines);
+			return;
+		}
+	}
+
+	shared_ptr<SegmentSet> segments = make_shared<SegmentSet>();
 
-	img_gray = RGB2Gray(getImage());
+	updateGradients();
 	Mat line_img;
-	blur(img_gray, line_img, Size(kernel_size, kernel_size));
-	Canny(line_img, line_img, getMinThr(), getMaxThr());
+	Canny(gradientX, gradientY, line_img, getMinThr(), getMaxThr());
+	if (houghBudget.edgeFraction < 1)
+		sampleEdges(line_img, houghBudget.edgeFraction);
+
 	vector<Vec4i> linesP;
-	HoughLinesP(line_img, linesP, 1, CV_PI / 180, 30, 30, 10); 
-	for (Vec4i& vec : linesP) {
-		std::vector<Point> pointRow;
-		for (int i = 0; i < 4; i += 2) {
-			Point point(vec[i], vec[i + 1]);
-			pointRow.push_back(point);
+	bool deadlineReached = false;
+	if (houghBudget.maxSegments == 0 && houghBudget.maxMilliseconds <= 0) {
+		HoughLinesP(line_img, linesP, hough.rho, hough.theta, hough.threshold, hough.minLineLength, hough.maxLineGap);
+	}
+	else {
+		double ticksPerMillisecond = getTickFrequency() / 1000.0;
+		int bandRows = max(128, int(4 * hough.minLineLength));
+		for (int first = 0; first < line_img.rows; first += bandRows) {
+			if (houghBudget.maxSegments > 0 && linesP.size() >= houghBudget.maxSegments) {
+				houghStoppedEarly = true;
+				break;
+			}
+			if (houghBudget.maxMilliseconds > 0 && (getTickCount() - start) / ticksPerMillisecond >= houghBudget.maxMilliseconds) {
+				houghStoppedEarly = deadlineReached = true;
+				break;
+			}
+			vector<Vec4i> band;
+			HoughLinesP(line_img.rowRange(first, min(line_img.rows, first + bandRows)), band,
+				hough.rho, hough.theta, hough.threshold, hough.minLineLength, hough.maxLineGap);
+			for (Vec4i vec : band) {
+				vec[1] += first;
+				vec[3] += first;
+				linesP.push_back(vec);
+			}
 		}
-		lines.push_back(pointRow);
+		if (houghBudget.maxSegments > 0 && linesP.size() >= houghBudget.maxSegments) {
+			linesP.resize(houghBudget.maxSegments);
+			houghStoppedEarly = true;
+		}
+	}
+	segments->reserve(linesP.size());
+	for (const Vec4i& vec : linesP) {
+		segments->push_back(vec);
+	}
+	if (cache && !deadlineReached)
+		cache->store(key, getID(), *segments);
+	setLine(segments);
+	setData(lines);
+}
+
+/// @details This member function recomputes the gray image when the image changed (see getImageVersion), and the
+/// blurred image and its gradients when the gray image or the kernel size changed. The gradients are the 3x3 Sobel
+/// derivatives with replicated borders, exactly what Canny computes internally for an 8-bit image.
+void LineDetection::updateGradients() {
+	if (grayImage.empty() || grayVersion != getImageVersion()) {
+		TRACE_SCOPE("LineDetection::grayImage");
+		grayImage = convertDepth(RGB2Gray(computeImage()), CV_8U);
+		grayVersion = getImageVersion();
+		blurredKernel = -1;
 	}
-	setLine(lines);
-	setData(getLine());
+	if (blurredKernel != kernel_size) {
+		TRACE_SCOPE("LineDetection::gradients");
+		// A copy of this object shares these buffers, so they are released instead of overwritten in place.
+		blurredImage.release();
+		gradientX.release();
+		gradientY.release();
+		blur(grayImage, blurredImage, Size(kernel_size, kernel_size));
+		Sobel(blurredImage, gradientX, CV_16S, 1, 0, 3, 1, 0, BORDER_REPLICATE);
+		Sobel(blurredImage, gradientY, CV_16S, 0, 1, 3, 1, 0, BORDER_REPLICATE);
+		blurredKernel = kernel_size;
+	}
+}
+
+/// @details This static member function thins the edge map for a faster Hough transform. Each edge pixel is kept
+/// when a hash of its position falls below the fraction, so the kept pixels are spread evenly and the same for every run.
+void LineDetection::sampleEdges(Mat& edges, double fraction) {
+	TRACE_SCOPE("LineDetection::sampleEdges");
+	uint32_t limit = uint32_t(max(0.0, min(fraction, 1.0)) * 65536.0);
+	for (int i = 0; i < edges.rows; i++) {
+		uchar* row = edges.ptr<uchar>(i);
+		for (int j = 0; j < edges.cols; j++) {
+			if (row[j] && ((uint32_t(j) * 73856093u ^ uint32_t(i) * 19349663u) >> 8 & 0xFFFF) >= limit)
+				row[j] = 0;
+		}
+	}
+}
+
+/// @details This member function sets the Hough transform parameters.
+void LineDetection::setHoughParameters(const HoughParameters& parameters) {
+	hough = parameters;
+}
+
+/// @details This member function returns the Hough transform parameters.
+HoughParameters LineDetection::getHoughParameters() {
+	return hough;
+}
+
+/// @details This member function sets the Hough transform budget.
+void LineDetection::setHoughBudget(const HoughBudget& budget) {
+	houghBudget = budget;
+}
+
+/// @details This member function returns the Hough transform budget.
+HoughBudget LineDetection::getHoughBudget() {
+	return houghBudget;
+}
+
+/// @details This member function returns whether the last findLine() stopped early.
+bool LineDetection::stoppedEarly() {
+	return houghStoppedEarly;
+}
+
+/// @details This member function sets the blur kernel size; the blurred image and gradients are recomputed on the next findLine().
+/// Sizes below 1 are raised to 1 (no blur), since blur rejects them.
+void LineDetection::setKernelSize(int kSize) {
+	kernel_size = max(kSize, 1);
+}
+
+/// @details This member function returns the blur kernel size.
+int LineDetection::getKernelSize() {
+	return kernel_size;
+}
+
+/// @details This member function lists the detector and all parameters findLine() depends on.
+/// Every new parameter of findLine() must be added here, otherwise cached results would be reused wrongly.
+string LineDetection::cacheParameters() {
+	ostringstream parameters;
+	parameters << "Line canny minThreshold=" << minThreshold << " maxThreshold=" << maxThreshold
+		<< " kernel_size=" << kernel_size << setprecision(17) << " hough=" << hough.rho << "," << hough.theta << ","
+		<< hough.threshold << "," << hough.minLineLength << "," << hough.maxLineGap
+		<< " banded=" << (houghBudget.maxSegments > 0 || houghBudget.maxMilliseconds > 0)
+		<< " maxSegments=" << houghBudget.maxSegments << " edgeFraction=" << houghBudget.edgeFraction;
+	return parameters.str();
 }
 
 /// @details This static function is called when the trackbar value changes.
 /// It is used in conjunction with visualizeFeatures_withTreackbar. This function sets minThreshold and calls findLine() and visualizeFeatures() functions.
 void LineDetection::changeTrackbar(int value, void* dataPtr) {
+	TRACE_SCOPE("LineDetection::changeTrackbar");
 	LineDetection* ptrObject = static_cast<LineDetection*>(dataPtr);
 	ptrObject->minThreshold = value;
 	ptrObject->findLine();
@@ -84,6 +238,7 @@ void LineDetection::changeTrackbar(int value, void* dataPtr) {
 /// @details This member function visualizes the features (lines) on the visual image while allowing the adjustment of the
 /// min threshold value through a trackbar.
 void LineDetection::visualizeFeatures_withTreackbar() {
+	TRACE_SCOPE("LineDetection::visualizeFeatures_withTreackbar");
 	namedWindow(getWindowName(), WINDOW_AUTOSIZE);
 	createTrackbar("Threshold:", getWindowName(), &getMinThr(), minThreshold * 3, changeTrackbar, this);
 	cout << minThreshold << endl;
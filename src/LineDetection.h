@@ -7,6 +7,35 @@
 #include "CommonProcesses.h"
 #include "Detection.h"
 #include <vector>
+#include <sstream>
+
+/// @brief Parameters of the probabilistic Hough transform (HoughLinesP) used by LineDetection.
+struct HoughParameters {
+	/// @brief Distance resolution of the accumulator in pixels.
+	double rho = 1;
+	/// @brief Angle resolution of the accumulator in radians.
+	double theta = CV_PI / 180;
+	/// @brief Minimum number of votes of a line.
+	int threshold = 30;
+	/// @brief Minimum length of a segment in pixels.
+	double minLineLength = 30;
+	/// @brief Maximum gap in pixels between points of the same segment.
+	double maxLineGap = 10;
+};
+
+/// @brief Budget of the Hough transform, for a predictable time per frame. The default budget is unlimited.
+/// With a segment limit or a deadline the edge map is processed in bands of rows, top to bottom, and processing
+/// stops after the band that reaches the limit; segments crossing band borders are split.
+struct HoughBudget {
+	/// @brief Maximum number of segments (0 is unlimited).
+	size_t maxSegments = 0;
+	/// @brief Deadline in milliseconds from the start of findLine (0 is no deadline).
+	/// It is checked between bands of at least 128 rows, so findLine can overrun it by the time of one band.
+	double maxMilliseconds = 0;
+	/// @brief Fraction of the edge pixels that vote, from 0 to 1 (1 uses every edge pixel).
+	double edgeFraction = 1;
+};
+
 /// @brief LineDetection class inherits from Detection.
 /// The LineDetection class is derived from the Detection class, inheriting its functionality and properties.
 class LineDetection: public Detection
@@ -45,12 +74,23 @@ public:
 	void findLine();
 
 	/// @brief Sets the line data for the image.
-	/// @param lines A vector of vectors of points representing the line data to be set.
-	void setLine(vector<vector<Point>>);
+	/// @param lines The line segments to be shared with the object.
+	void setLine(shared_ptr<const SegmentSet>);
 
-	/// @brief Gets the line data from the image.
-	/// @return A vector of vectors of points containing the line data.
-	vector<vector<Point>> getLine();
+	/// @brief Gets the line data from the image without copying it.
+	/// @return A const reference to the line segments.
+	const SegmentSet& getLine();
+
+	/// @brief Computes the geometry of all detected lines in one batch.
+	/// @param bins The number of orientation histogram bins (default is 18).
+	/// @return The lengths, orientations, midpoints, orientation histogram and length percentiles of the lines.
+	SegmentStats getLineStats(int = 18);
+
+	/// @brief Loads the lines for the image from an indexed feature file.
+	/// @param file The mapped feature file.
+	/// @param id The ID of the image in the file (default is the ID of the object).
+	/// @return True if the file contains line segments for the image.
+	bool loadFeatures(const FeatureFile&, string = "") override;
 
 	/// @brief Visualizes features with a trackbar for LineDetection.
 	void visualizeFeatures_withTreackbar();
@@ -68,18 +108,75 @@ public:
 	/// @return The reference to the minimum threshold value.
 	int& getMinThr();
 
+	/// @brief Sets the parameters of the Hough transform.
+	/// @param parameters The parameters (default is rho 1, theta 1 degree, threshold 30, minLineLength 30, maxLineGap 10).
+	void setHoughParameters(const HoughParameters&);
+
+	/// @brief Gets the parameters of the Hough transform.
+	/// @return The parameters.
+	HoughParameters getHoughParameters();
+
+	/// @brief Sets the budget of the Hough transform.
+	/// @param budget The budget (default is unlimited).
+	void setHoughBudget(const HoughBudget&);
+
+	/// @brief Gets the budget of the Hough transform.
+	/// @return The budget.
+	HoughBudget getHoughBudget();
+
+	/// @brief Checks whether the last findLine() stopped before the whole edge map was processed.
+	/// @return True if the result reached the segment limit or the deadline of the budget ended the Hough transform early.
+	bool stoppedEarly();
+
+	/// @brief Sets the blur kernel size applied before edge detection.
+	/// @param kernelSize The kernel size (at least 1).
+	void setKernelSize(int);
+
+	/// @brief Gets the blur kernel size applied before edge detection.
+	/// @return The kernel size.
+	int getKernelSize();
+
 	/// @brief This function is a destructor of the Line Detection class.
 	~LineDetection();
 
 
 private:
-	/// @brief Detected lines in the image.
-	vector<vector<Point>> lines;
+	/// @brief Describes every parameter that influences findLine(), for the result cache key.
+	/// @return The parameter string.
+	string cacheParameters();
+
+	/// @brief Computes the gray image, the blurred image and its Sobel gradients, unless they are still valid.
+	/// They depend only on the image and the kernel size, not on the thresholds.
+	void updateGradients();
+
+	/// @brief Keeps a deterministic, evenly spread fraction of the edge pixels and clears the others.
+	/// @param edges The edge map.
+	/// @param fraction The fraction of edge pixels to keep.
+	static void sampleEdges(Mat&, double);
+
+	/// @brief Detected lines in the image, shared with the Detection data.
+	shared_ptr<const SegmentSet> lines = make_shared<const SegmentSet>();
 	/// @brief Minimum threshold value for line detection.
 	int minThreshold;
 	/// @brief Maximum threshold value for line detection (constant).
 	const int maxThreshold;
-	/// @brief Kernel size for line detection (constant).
-	const int kernel_size;
+	/// @brief Kernel size for line detection.
+	int kernel_size;
+
+	/// @brief Gray image and the image version it was computed from.
+	Mat grayImage;
+	uint64_t grayVersion = 0;
+	/// @brief Blurred gray image and its Sobel gradients (CV_16S), kept across threshold changes.
+	Mat blurredImage;
+	Mat gradientX;
+	Mat gradientY;
+	/// @brief Kernel size the blurred image was computed with (-1 if none).
+	int blurredKernel = -1;
+
+	/// @brief Hough transform parameters and budget.
+	HoughParameters hough;
+	HoughBudget houghBudget;
+	/// @brief Whether the last findLine() stopped early.
+	bool houghStoppedEarly = false;
 };
 
@@ -0,0 +1,68 @@
+// Author: Burak Özdemir
+#include "SegmentStats.h"
+#include <algorithm>
+#include <numeric>
+
+/// @details This constructor wraps the coordinate columns of the set in Mat headers without copying them and
+/// computes all segments at once: the differences and midpoints with subtract and addWeighted,
+/// the lengths with magnitude and the orientations with phase. Orientations are folded into [0, 180);
+/// phase can return 360 for a segment pointing along the negative x axis, so the fold is applied twice.
+SegmentStats::SegmentStats(const SegmentSet& segments, int bins)
+	:orientationHistogram(max(bins, 1), 0), orientationLengthHistogram(max(bins, 1), 0.0f)
+{
+	int n = int(segments.size());
+	if (n == 0)
+		return;
+
+	Mat x1(1, n, CV_32S, const_cast<int*>(segments.x1.data()));
+	Mat y1(1, n, CV_32S, const_cast<int*>(segments.y1.data()));
+	Mat x2(1, n, CV_32S, const_cast<int*>(segments.x2.data()));
+	Mat y2(1, n, CV_32S, const_cast<int*>(segments.y2.data()));
+
+	Mat dx, dy;
+	subtract(x2, x1, dx, noArray(), CV_32F);
+	subtract(y2, y1, dy, noArray(), CV_32F);
+
+	length.resize(n);
+	orientation.resize(n);
+	midX.resize(n);
+	midY.resize(n);
+	Mat lengthMat(1, n, CV_32F, length.data());
+	Mat orientationMat(1, n, CV_32F, orientation.data());
+	Mat midXMat(1, n, CV_32F, midX.data());
+	Mat midYMat(1, n, CV_32F, midY.data());
+
+	magnitude(dx, dy, lengthMat);
+	phase(dx, dy, orientationMat, true);
+	subtract(orientationMat, Scalar(180), orientationMat, orientationMat >= 180);
+	subtract(orientationMat, Scalar(180), orientationMat, orientationMat >= 180);
+	addWeighted(x1, 0.5, x2, 0.5, 0, midXMat, CV_32F);
+	addWeighted(y1, 0.5, y2, 0.5, 0, midYMat, CV_32F);
+
+	int binCount = int(orientationHistogram.size());
+	float binScale = binCount / 180.0f;
+	for (int i = 0; i < n; i++) {
+		int bin = min(int(orientation[i] * binScale), binCount - 1);
+		orientationHistogram[bin] += 1;
+		orientationLengthHistogram[bin] += length[i];
+	}
+
+	sortedLength = length;
+	sort(sortedLength.begin(), sortedLength.end());
+}
+
+/// @details This function interpolates between the two closest ranks of the sorted lengths.
+float SegmentStats::lengthPercentile(double p) const {
+	if (sortedLength.empty())
+		return 0;
+	double rank = min(max(p, 0.0), 100.0) / 100.0 * (sortedLength.size() - 1);
+	size_t lower = size_t(rank);
+	size_t upper = min(lower + 1, sortedLength.size() - 1);
+	double t = rank - lower;
+	return float(sortedLength[lower] * (1 - t) + sortedLength[upper] * t);
+}
+
+/// @details This function adds up the lengths in double precision.
+double SegmentStats::totalLength() const {
+	return accumulate(length.begin(), length.end(), 0.0);
+}
@@ -0,0 +1,48 @@
+// Author: Burak Özdemir
+#pragma once
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "Features.h"
+
+using namespace std;
+using namespace cv;
+
+/// @brief SegmentStats holds the geometry of all segments of a SegmentSet, computed in one batch.
+/// Lengths, orientations and midpoints are computed column-wise with OpenCV's vectorized array functions
+/// (subtract, magnitude, phase, addWeighted) instead of one segment at a time.
+struct SegmentStats {
+	/// @brief Constructor for SegmentStats. Computes the geometry of every segment.
+	/// @param segments The line segments.
+	/// @param bins The number of orientation histogram bins over [0, 180) degrees (default is 18, i.e. 10 degrees per bin).
+	SegmentStats(const SegmentSet&, int = 18);
+
+	/// @brief Length of each segment in pixels.
+	vector<float> length;
+	/// @brief Orientation of each segment in degrees, in [0, 180) (segments are undirected).
+	vector<float> orientation;
+	/// @brief Midpoint of each segment.
+	vector<float> midX;
+	vector<float> midY;
+
+	/// @brief Number of segments per orientation bin; bin i covers [i * 180 / bins, (i + 1) * 180 / bins).
+	vector<int> orientationHistogram;
+	/// @brief Number of segments per orientation bin, weighted by segment length.
+	vector<float> orientationLengthHistogram;
+
+	/// @brief Gets the number of segments.
+	/// @return The number of segments.
+	size_t size() const { return length.size(); }
+
+	/// @brief Gets a length percentile (linear interpolation between the closest ranks).
+	/// @param p The percentile, from 0 (shortest) to 100 (longest).
+	/// @return The length at the percentile, or 0 if there are no segments.
+	float lengthPercentile(double) const;
+
+	/// @brief Gets the sum of all segment lengths.
+	/// @return The total length in pixels.
+	double totalLength() const;
+
+private:
+	/// @brief Segment lengths in ascending order, for percentile queries.
+	vector<float> sortedLength;
+};
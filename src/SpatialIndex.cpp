@@ -0,0 +1,362 @@
+// Author: Burak Özdemir
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace {
+
+	/// @brief Maximum number of segments in a leaf of a SegmentTree.
+	const int leafSize = 4;
+
+	/// @brief A (squared distance, index) candidate of a nearest-neighbor query.
+	typedef pair<float, size_t> Candidate;
+
+	/// @brief Keeps the k best candidates in a max-heap.
+	void offer(vector<Candidate>& heap, size_t k, float d2, size_t i) {
+		if (heap.size() < k) {
+			heap.emplace_back(d2, i);
+			push_heap(heap.begin(), heap.end());
+		}
+		else if (d2 < heap.front().first) {
+			pop_heap(heap.begin(), heap.end());
+			heap.back() = Candidate(d2, i);
+			push_heap(heap.begin(), heap.end());
+		}
+	}
+
+	/// @brief Turns the heap into indices ordered by distance.
+	vector<size_t> sortedIndices(vector<Candidate>& heap) {
+		sort_heap(heap.begin(), heap.end());
+		vector<size_t> result;
+		result.reserve(heap.size());
+		for (const Candidate& c : heap)
+			result.push_back(c.second);
+		return result;
+	}
+}
+
+/// @details This constructor only stores the cell size.
+CornerGrid::CornerGrid(int size)
+	:requestedCellSize(max(size, 1)), cellSize(max(size, 1))
+{
+}
+
+/// @details This function lays out the cells for the corners and indexes all of them.
+void CornerGrid::build(shared_ptr<const CornerSet> set) {
+	corners = set;
+	source.reset();
+	layout(corners ? *corners : CornerSet());
+	cellEnd.assign(cellStart.begin() + (cellStart.empty() ? 0 : 1), cellStart.end());
+}
+
+/// @details This function reuses the cells while the source stays the same. Within a cell the items are in ascending
+/// index order, so the indexed corners of each cell come first and a prefix grows or shrinks by moving the end of the
+/// cells of the corners that were added or removed: a new threshold costs time proportional to the change, not to the set.
+/// The cells are sized for the whole source, so a short prefix of a large source leaves many cells empty.
+void CornerGrid::buildPrefix(shared_ptr<const CornerSet> set, const shared_ptr<const CornerSet>& from) {
+	if (!set || !from || set->size() > from->size()) {
+		build(set);
+		return;
+	}
+	size_t previous = 0;
+	if (corners && source.lock() == from) {
+		previous = corners->size();
+	}
+	else {
+		layout(*from);
+		cellEnd.assign(cellStart.begin(), cellStart.end() - (cellStart.empty() ? 0 : 1));
+		source = from;
+	}
+	for (size_t i = set->size(); i < previous; i++)
+		cellEnd[cellOf(corners->x[i], corners->y[i])]--;
+	for (size_t i = previous; i < set->size(); i++)
+		cellEnd[cellOf(set->x[i], set->y[i])]++;
+	corners = set;
+}
+
+/// @details This function buckets the corners by cell with a counting sort. The grid covers the bounding box of
+/// the corners; the cell size is doubled while there are many more cells than corners, so sparse sets stay small.
+void CornerGrid::layout(const CornerSet& c) {
+	cellStart.clear();
+	items.clear();
+	cols = rows = 0;
+	if (c.empty())
+		return;
+
+	int n = int(c.size());
+	int minX = *min_element(c.x.begin(), c.x.end()), maxX = *max_element(c.x.begin(), c.x.end());
+	int minY = *min_element(c.y.begin(), c.y.end()), maxY = *max_element(c.y.begin(), c.y.end());
+	cellSize = requestedCellSize;
+	while (int64_t((maxX - minX) / cellSize + 1) * ((maxY - minY) / cellSize + 1) > 4 * int64_t(n) + 64)
+		cellSize *= 2;
+	originX = minX;
+	originY = minY;
+	cols = (maxX - minX) / cellSize + 1;
+	rows = (maxY - minY) / cellSize + 1;
+
+	cellStart.assign(size_t(cols) * rows + 1, 0);
+	for (int i = 0; i < n; i++)
+		cellStart[cellOf(c.x[i], c.y[i]) + 1] += 1;
+	for (size_t cell = 1; cell < cellStart.size(); cell++)
+		cellStart[cell] += cellStart[cell - 1];
+	items.resize(n);
+	vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+	for (int i = 0; i < n; i++)
+		items[fill[cellOf(c.x[i], c.y[i])]++] = i;
+}
+
+/// @details This function assumes the position lies in the grid.
+size_t CornerGrid::cellOf(int x, int y) const {
+	return size_t((y - originY) / cellSize) * cols + (x - originX) / cellSize;
+}
+
+/// @details This function compares the shared data pointers, so a new detection result always triggers a rebuild.
+bool CornerGrid::isBuiltFrom(const shared_ptr<const CornerSet>& set) const {
+	return corners == set;
+}
+
+/// @details This function converts a box to the range of grid cells overlapping it; the range is empty
+/// (c0 > c1 or r0 > r1) when the box misses the grid.
+void CornerGrid::cellRange(float x0, float y0, float x1, float y1, int& c0, int& r0, int& c1, int& r1) const {
+	c0 = max(0, int(floor((x0 - originX) / cellSize)));
+	r0 = max(0, int(floor((y0 - originY) / cellSize)));
+	c1 = min(cols - 1, int(floor((x1 - originX) / cellSize)));
+	r1 = min(rows - 1, int(floor((y1 - originY) / cellSize)));
+}
+
+/// @details This function visits the cells overlapping the rectangle and tests the corners in them.
+vector<size_t> CornerGrid::queryRect(Rect rect) const {
+	vector<size_t> result;
+	if (cols == 0 || rect.empty())
+		return result;
+	int c0, r0, c1, r1;
+	cellRange(float(rect.x), float(rect.y), float(rect.x + rect.width - 1), float(rect.y + rect.height - 1), c0, r0, c1, r1);
+	const CornerSet& c = *corners;
+	for (int r = r0; r <= r1; r++)
+		for (int col = c0; col <= c1; col++) {
+			size_t cell = size_t(r) * cols + col;
+			for (int k = cellStart[cell]; k < cellEnd[cell]; k++)
+				if (rect.contains(c.point(items[k])))
+					result.push_back(size_t(items[k]));
+		}
+	return result;
+}
+
+/// @details This function visits the cells overlapping the bounding box of the circle and tests the corners in them.
+vector<size_t> CornerGrid::queryRadius(Point2f center, float radius) const {
+	vector<size_t> result;
+	if (cols == 0 || radius < 0)
+		return result;
+	int c0, r0, c1, r1;
+	cellRange(center.x - radius, center.y - radius, center.x + radius, center.y + radius, c0, r0, c1, r1);
+	const CornerSet& c = *corners;
+	float radius2 = radius * radius;
+	for (int r = r0; r <= r1; r++)
+		for (int col = c0; col <= c1; col++) {
+			size_t cell = size_t(r) * cols + col;
+			for (int k = cellStart[cell]; k < cellEnd[cell]; k++) {
+				float dx = c.x[items[k]] - center.x, dy = c.y[items[k]] - center.y;
+				if (dx * dx + dy * dy <= radius2)
+					result.push_back(size_t(items[k]));
+			}
+		}
+	return result;
+}
+
+/// @details This function searches rings of cells around the cell of the point, nearest ring first.
+/// Every corner in ring r is at least (r - 1) cells away, so the search stops as soon as k corners were found
+/// that are all nearer than the next ring.
+vector<size_t> CornerGrid::nearest(Point2f p, size_t k) const {
+	vector<Candidate> heap;
+	if (cols == 0 || k == 0 || corners->empty())
+		return vector<size_t>();
+	heap.reserve(k + 1);
+	const CornerSet& c = *corners;
+	int pc = min(max(int(floor((p.x - originX) / cellSize)), 0), cols - 1);
+	int pr = min(max(int(floor((p.y - originY) / cellSize)), 0), rows - 1);
+	int maxRing = max(max(pc, cols - 1 - pc), max(pr, rows - 1 - pr));
+
+	for (int ring = 0; ring <= maxRing; ring++) {
+		float bound = float(max(ring - 1, 0) * cellSize);
+		if (heap.size() == k && bound * bound > heap.front().first)
+			break;
+		for (int r = pr - ring; r <= pr + ring; r++) {
+			if (r < 0 || r >= rows)
+				continue;
+			bool edgeRow = r == pr - ring || r == pr + ring;
+			for (int col = pc - ring; col <= pc + ring; col += edgeRow ? 1 : 2 * ring) {
+				if (col >= 0 && col < cols) {
+					size_t cell = size_t(r) * cols + col;
+					for (int i = cellStart[cell]; i < cellEnd[cell]; i++) {
+						float dx = c.x[items[i]] - p.x, dy = c.y[items[i]] - p.y;
+						offer(heap, k, dx * dx + dy * dy, size_t(items[i]));
+					}
+				}
+				if (ring == 0)
+					break;
+			}
+		}
+	}
+	return sortedIndices(heap);
+}
+
+/// @details This function builds the tree top-down from the segment midpoints.
+void SegmentTree::build(shared_ptr<const SegmentSet> set) {
+	segments = set;
+	nodes.clear();
+	items.clear();
+	if (!segments || segments->empty())
+		return;
+
+	const SegmentSet& s = *segments;
+	int n = int(s.size());
+	items.resize(n);
+	mids.resize(n);
+	for (int i = 0; i < n; i++) {
+		items[i] = i;
+		mids[i] = Point2f((s.x1[i] + s.x2[i]) * 0.5f, (s.y1[i] + s.y2[i]) * 0.5f);
+	}
+	nodes.reserve(size_t(2 * n / leafSize + 1));
+	buildNode(0, n);
+}
+
+/// @details This function computes the bounding box of the segments in [first, last). Small ranges become leaves;
+/// larger ones are split at the median midpoint along the longer side of the box.
+int SegmentTree::buildNode(int first, int last) {
+	const SegmentSet& s = *segments;
+	Node node;
+	node.minX = node.minY = numeric_limits<float>::max();
+	node.maxX = node.maxY = numeric_limits<float>::lowest();
+	for (int k = first; k < last; k++) {
+		int i = items[k];
+		node.minX = min(node.minX, float(min(s.x1[i], s.x2[i])));
+		node.maxX = max(node.maxX, float(max(s.x1[i], s.x2[i])));
+		node.minY = min(node.minY, float(min(s.y1[i], s.y2[i])));
+		node.maxY = max(node.maxY, float(max(s.y1[i], s.y2[i])));
+	}
+	node.first = first;
+	node.count = last - first;
+	node.left = node.right = -1;
+	int index = int(nodes.size());
+	nodes.push_back(node);
+	if (last - first <= leafSize)
+		return index;
+
+	bool splitX = node.maxX - node.minX >= node.maxY - node.minY;
+	int middle = (first + last) / 2;
+	nth_element(items.begin() + first, items.begin() + middle, items.begin() + last, [&](int a, int b) {
+		return splitX ? mids[a].x < mids[b].x : mids[a].y < mids[b].y;
+	});
+	int left = buildNode(first, middle);
+	int right = buildNode(middle, last);
+	nodes[index].count = 0;
+	nodes[index].left = left;
+	nodes[index].right = right;
+	return index;
+}
+
+/// @details This function compares the shared data pointers, so a new detection result always triggers a rebuild.
+bool SegmentTree::isBuiltFrom(const shared_ptr<const SegmentSet>& set) const {
+	return segments == set;
+}
+
+/// @details This function returns zero for a point inside the box.
+float SegmentTree::boxDistance2(const Node& node, Point2f p) const {
+	float dx = max(max(node.minX - p.x, 0.0f), p.x - node.maxX);
+	float dy = max(max(node.minY - p.y, 0.0f), p.y - node.maxY);
+	return dx * dx + dy * dy;
+}
+
+/// @details This function projects the point onto the segment, clamped to its end points.
+float SegmentTree::distance2(Point2f p, size_t i) const {
+	const SegmentSet& s = *segments;
+	float ax = float(s.x1[i]), ay = float(s.y1[i]);
+	float dx = s.x2[i] - ax, dy = s.y2[i] - ay;
+	float len2 = dx * dx + dy * dy;
+	float t = len2 > 0 ? min(max(((p.x - ax) * dx + (p.y - ay) * dy) / len2, 0.0f), 1.0f) : 0.0f;
+	float ex = ax + t * dx - p.x, ey = ay + t * dy - p.y;
+	return ex * ex + ey * ey;
+}
+
+/// @details This function descends into the nodes whose box overlaps the rectangle and tests the segments of
+/// the leaves with clipLine, which reports whether a segment passes through the rectangle.
+vector<size_t> SegmentTree::queryRect(Rect rect) const {
+	vector<size_t> result;
+	if (nodes.empty() || rect.empty())
+		return result;
+	const SegmentSet& s = *segments;
+	float rx0 = float(rect.x), ry0 = float(rect.y);
+	float rx1 = float(rect.x + rect.width - 1), ry1 = float(rect.y + rect.height - 1);
+	vector<int> stack(1, 0);
+	while (!stack.empty()) {
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+		if (node.maxX < rx0 || node.minX > rx1 || node.maxY < ry0 || node.minY > ry1)
+			continue;
+		if (node.count == 0) {
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+			continue;
+		}
+		for (int k = node.first; k < node.first + node.count; k++) {
+			Point a = s.start(items[k]), b = s.end(items[k]);
+			if (clipLine(rect, a, b))
+				result.push_back(size_t(items[k]));
+		}
+	}
+	return result;
+}
+
+/// @details This function descends into the nodes whose box is within the distance and tests the segments of the leaves.
+vector<size_t> SegmentTree::queryRadius(Point2f center, float radius) const {
+	vector<size_t> result;
+	if (nodes.empty() || radius < 0)
+		return result;
+	float radius2 = radius * radius;
+	vector<int> stack(1, 0);
+	while (!stack.empty()) {
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+		if (boxDistance2(node, center) > radius2)
+			continue;
+		if (node.count == 0) {
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+			continue;
+		}
+		for (int k = node.first; k < node.first + node.count; k++)
+			if (distance2(center, size_t(items[k])) <= radius2)
+				result.push_back(size_t(items[k]));
+	}
+	return result;
+}
+
+/// @details This function visits the nodes best-first, ordered by the distance to their box, and stops when the
+/// nearest unvisited box is farther than the k-th best segment found.
+vector<size_t> SegmentTree::nearest(Point2f p, size_t k) const {
+	vector<Candidate> heap;
+	if (nodes.empty() || k == 0)
+		return vector<size_t>();
+	heap.reserve(k + 1);
+	typedef pair<float, int> Entry;
+	priority_queue<Entry, vector<Entry>, greater<Entry>> open;
+	open.emplace(boxDistance2(nodes[0], p), 0);
+	while (!open.empty()) {
+		Entry top = open.top();
+		open.pop();
+		if (heap.size() == k && top.first > heap.front().first)
+			break;
+		const Node& node = nodes[top.second];
+		if (node.count == 0) {
+			open.emplace(boxDistance2(nodes[node.left], p), node.left);
+			open.emplace(boxDistance2(nodes[node.right], p), node.right);
+			continue;
+		}
+		for (int i = node.first; i < node.first + node.count; i++)
+			offer(heap, k, distance2(p, size_t(items[i])), size_t(items[i]));
+	}
+	return sortedIndices(heap);
+}
@@ -0,0 +1,152 @@
+// Author: Burak Özdemir
+#pragma once
+#include <memory>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "Features.h"
+
+using namespace std;
+using namespace cv;
+
+/// @brief CornerGrid is a uniform grid over a CornerSet for region and nearest-neighbor queries.
+/// Corner indices are bucketed per cell in one contiguous array (counting sort), so building is linear and
+/// a query only visits the cells it overlaps. Queries return indices into the indexed CornerSet.
+/// A set that holds the first corners of a larger set (see buildPrefix) is indexed in cells laid out for the larger set,
+/// so a longer or shorter prefix of it only adds or removes the corners in which the two differ.
+class CornerGrid {
+public:
+	/// @brief Constructor for CornerGrid. The grid is empty until build() is called.
+	/// @param cellSize The side of a grid cell in pixels (default is 16); it grows for sparse sets.
+	CornerGrid(int = 16);
+
+	/// @brief Indexes a corner set. The buffers of the previous build are reused.
+	/// @param corners The corners (kept alive by the index).
+	void build(shared_ptr<const CornerSet>);
+
+	/// @brief Indexes a corner set that holds the first corners of a source set, e.g. the corners above a threshold
+	/// taken from a strength-ordered candidate list. The cells are laid out for the whole source on its first use;
+	/// if the previous set was a prefix of the same source, only the corners in which the two sets differ are added or removed.
+	/// @param corners The corners (kept alive by the index).
+	/// @param source The set whose first corners.size() corners equal the corners.
+	void buildPrefix(shared_ptr<const CornerSet>, const shared_ptr<const CornerSet>&);
+
+	/// @brief Checks whether the index was built from the given corner set.
+	/// @param corners The corners.
+	/// @return True if the index is up to date for the set.
+	bool isBuiltFrom(const shared_ptr<const CornerSet>&) const;
+
+	/// @brief Finds the corners inside a rectangle.
+	/// @param rect The rectangle.
+	/// @return The indices of the corners inside the rectangle.
+	vector<size_t> queryRect(Rect) const;
+
+	/// @brief Finds the corners within a distance of a point.
+	/// @param center The point.
+	/// @param radius The distance in pixels.
+	/// @return The indices of the corners within the distance.
+	vector<size_t> queryRadius(Point2f, float) const;
+
+	/// @brief Finds the k corners nearest to a point.
+	/// @param p The point.
+	/// @param k The number of corners.
+	/// @return The indices of the nearest corners, nearest first.
+	vector<size_t> nearest(Point2f, size_t) const;
+
+private:
+	/// @brief Gets the cell range overlapping a rectangle given by its corners (clamped to the grid).
+	void cellRange(float, float, float, float, int&, int&, int&, int&) const;
+
+	/// @brief Lays out the cells for a set and buckets all of its corners, in ascending index order per cell.
+	/// @param set The corners.
+	void layout(const CornerSet&);
+
+	/// @brief Gets the cell of a position inside the grid.
+	size_t cellOf(int, int) const;
+
+	/// @brief Indexed corners.
+	shared_ptr<const CornerSet> corners;
+	/// @brief Set the cells were laid out for by buildPrefix (expired or empty if they were laid out for the corners).
+	weak_ptr<const CornerSet> source;
+	/// @brief Requested and actual cell size in pixels.
+	int requestedCellSize;
+	int cellSize;
+	/// @brief Position of the top-left cell and size of the grid in cells.
+	int originX = 0;
+	int originY = 0;
+	int cols = 0;
+	int rows = 0;
+	/// @brief Start of each cell in items (one more entry than cells).
+	vector<int> cellStart;
+	/// @brief Corner indices ordered by cell.
+	vector<int> items;
+	/// @brief End of the indexed corners of each cell; the items between it and the next cell start belong to a
+	/// source corner beyond the indexed prefix.
+	vector<int> cellEnd;
+};
+
+/// @brief SegmentTree is a bounding volume hierarchy over a SegmentSet for region and nearest-neighbor queries.
+/// Segments are split at the median of their midpoints along the longer axis, so the tree is balanced and
+/// queries take logarithmic time. Each level partitions all segments with nth_element, so building takes O(n log n).
+/// Queries return indices into the indexed SegmentSet.
+class SegmentTree {
+public:
+	/// @brief Indexes a segment set. The buffers of the previous build are reused.
+	/// @param segments The line segments (kept alive by the index).
+	void build(shared_ptr<const SegmentSet>);
+
+	/// @brief Checks whether the index was built from the given segment set.
+	/// @param segments The line segments.
+	/// @return True if the index is up to date for the set.
+	bool isBuiltFrom(const shared_ptr<const SegmentSet>&) const;
+
+	/// @brief Finds the segments crossing or inside a rectangle.
+	/// @param rect The rectangle.
+	/// @return The indices of the segments touching the rectangle.
+	vector<size_t> queryRect(Rect) const;
+
+	/// @brief Finds the segments within a distance of a point.
+	/// @param center The point.
+	/// @param radius The distance in pixels.
+	/// @return The indices of the segments within the distance.
+	vector<size_t> queryRadius(Point2f, float) const;
+
+	/// @brief Finds the k segments nearest to a point.
+	/// @param p The point.
+	/// @param k The number of segments.
+	/// @return The indices of the nearest segments, nearest first.
+	vector<size_t> nearest(Point2f, size_t) const;
+
+	/// @brief Gets the squared distance between a point and a segment.
+	/// @param p The point.
+	/// @param i The index of the segment.
+	/// @return The squared distance.
+	float distance2(Point2f, size_t) const;
+
+private:
+	/// @brief A tree node: a bounding box and either two children or a range of items.
+	struct Node {
+		float minX, minY, maxX, maxY;
+		/// @brief First item and number of items of a leaf (count is 0 for inner nodes).
+		int first;
+		int count;
+		/// @brief Children of an inner node.
+		int left;
+		int right;
+	};
+
+	/// @brief Builds the subtree of an item range.
+	/// @return The index of the subtree's root node.
+	int buildNode(int, int);
+
+	/// @brief Gets the squared distance between a point and the bounding box of a node.
+	float boxDistance2(const Node&, Point2f) const;
+
+	/// @brief Indexed segments.
+	shared_ptr<const SegmentSet> segments;
+	/// @brief Tree nodes; the root is node 0.
+	vector<Node> nodes;
+	/// @brief Segment indices ordered by leaf.
+	vector<int> items;
+	/// @brief Segment midpoints, used while building.
+	vector<Point2f> mids;
+};
@@ -0,0 +1,134 @@
+// Author: Burak Özdemir
+#include "ThresholdKernel.h"
+#include <opencv2/opencv.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IPA_THRESHOLD_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define IPA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define IPA_TARGET(isa)
+#endif
+#endif
+
+namespace {
+
+	/// @brief Tests one pixel; the reference for every vector path.
+	int compactScalar(const float* response, const float* maximum, int first, int width, float minResponse, int* columns) {
+		int count = 0;
+		for (int j = first; j < width; j++)
+			if (response[j] >= minResponse && response[j] >= maximum[j])
+				columns[count++] = j;
+		return count;
+	}
+
+#ifdef IPA_THRESHOLD_X86
+	/// @brief For each 8-bit mask, the lanes of its set bits moved to the front (the AVX2 compaction table).
+	struct PermutationTable {
+		alignas(32) int lanes[256][8];
+		PermutationTable() {
+			for (int mask = 0; mask < 256; mask++) {
+				int n = 0;
+				for (int lane = 0; lane < 8; lane++)
+					if (mask & (1 << lane))
+						lanes[mask][n++] = lane;
+				for (; n < 8; n++)
+					lanes[mask][n] = 0;
+			}
+		}
+	};
+	const PermutationTable permutation;
+
+	/// @brief Compares 8 pixels at a time, turns the comparison into an 8-bit mask with movemask and moves the
+	/// passing column indices to the front with a table driven permutation before storing all 8 lanes.
+	IPA_TARGET("avx2,popcnt")
+	int compactAvx2(const float* response, const float* maximum, int width, float minResponse, int* columns) {
+		const __m256 minimum = _mm256_set1_ps(minResponse);
+		const __m256i step = _mm256_set1_epi32(8);
+		__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		int count = 0;
+		int j = 0;
+		for (; j + 8 <= width; j += 8) {
+			__m256 r = _mm256_loadu_ps(response + j);
+			__m256 m = _mm256_loadu_ps(maximum + j);
+			__m256 pass = _mm256_and_ps(_mm256_cmp_ps(r, minimum, _CMP_GE_OQ), _mm256_cmp_ps(r, m, _CMP_GE_OQ));
+			int mask = _mm256_movemask_ps(pass);
+			if (mask) {
+				__m256i order = _mm256_load_si256(reinterpret_cast<const __m256i*>(permutation.lanes[mask]));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(columns + count), _mm256_permutevar8x32_epi32(index, order));
+				count += _mm_popcnt_u32(unsigned(mask));
+			}
+			index = _mm256_add_epi32(index, step);
+		}
+		return count + compactScalar(response, maximum, j, width, minResponse, columns + count);
+	}
+
+	/// @brief Compares 16 pixels at a time into a mask register and writes the passing column indices with a compress-store.
+	IPA_TARGET("avx512f,popcnt")
+	int compactAvx512(const float* response, const float* maximum, int width, float minResponse, int* columns) {
+		const __m512 minimum = _mm512_set1_ps(minResponse);
+		const __m512i step = _mm512_set1_epi32(16);
+		__m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		int count = 0;
+		int j = 0;
+		for (; j + 16 <= width; j += 16) {
+			__m512 r = _mm512_loadu_ps(response + j);
+			__m512 m = _mm512_loadu_ps(maximum + j);
+			__mmask16 pass = _mm512_cmp_ps_mask(r, minimum, _CMP_GE_OQ) & _mm512_cmp_ps_mask(r, m, _CMP_GE_OQ);
+			_mm512_mask_compressstoreu_epi32(columns + count, pass, index);
+			count += _mm_popcnt_u32(unsigned(pass));
+			index = _mm512_add_epi32(index, step);
+		}
+		return count + compactScalar(response, maximum, j, width, minResponse, columns + count);
+	}
+#endif
+}
+
+/// @details This function runs the requested path, or the best supported one for THRESHOLD_AUTO.
+/// Vector paths handle whole blocks and finish the row tail with the scalar loop.
+int ThresholdKernel::compact(const float* response, const float* maximum, int width, float minResponse, int* columns, ThresholdPath path) {
+	if (path == THRESHOLD_AUTO || !isSupported(path))
+		path = path == THRESHOLD_AUTO ? bestPath() : THRESHOLD_SCALAR;
+#ifdef IPA_THRESHOLD_X86
+	if (path == THRESHOLD_AVX512)
+		return compactAvx512(response, maximum, width, minResponse, columns);
+	if (path == THRESHOLD_AVX2)
+		return compactAvx2(response, maximum, width, minResponse, columns);
+#endif
+	return compactScalar(response, maximum, 0, width, minResponse, columns);
+}
+
+/// @details This function asks OpenCV for the CPU features; the vector paths are only compiled for x86.
+bool ThresholdKernel::isSupported(ThresholdPath path) {
+	switch (path) {
+	case THRESHOLD_AUTO:
+	case THRESHOLD_SCALAR:
+		return true;
+#ifdef IPA_THRESHOLD_X86
+	case THRESHOLD_AVX2:
+		return cv::checkHardwareSupport(CV_CPU_AVX2) && cv::checkHardwareSupport(CV_CPU_POPCNT);
+	case THRESHOLD_AVX512:
+		return cv::checkHardwareSupport(CV_CPU_AVX_512F) && cv::checkHardwareSupport(CV_CPU_POPCNT);
+#endif
+	default:
+		return false;
+	}
+}
+
+/// @details This function checks the CPU once and remembers the result.
+ThresholdPath ThresholdKernel::bestPath() {
+	static const ThresholdPath best = isSupported(THRESHOLD_AVX512) ? THRESHOLD_AVX512
+		: isSupported(THRESHOLD_AVX2) ? THRESHOLD_AVX2 : THRESHOLD_SCALAR;
+	return best;
+}
+
+/// @details This function returns a short name for logs and traces.
+string ThresholdKernel::pathName(ThresholdPath path) {
+	switch (path) {
+	case THRESHOLD_SCALAR: return "scalar";
+	case THRESHOLD_AVX2: return "AVX2";
+	case THRESHOLD_AVX512: return "AVX-512";
+	default: return "auto";
+	}
+}
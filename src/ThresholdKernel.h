@@ -0,0 +1,44 @@
+// Author: Burak Özdemir
+#pragma once
+#include <string>
+
+using namespace std;
+
+/// @brief Instruction set paths of ThresholdKernel.
+enum ThresholdPath {
+	THRESHOLD_AUTO,    ///< The fastest path the CPU supports.
+	THRESHOLD_SCALAR,  ///< One pixel at a time; available everywhere.
+	THRESHOLD_AVX2,    ///< 8 pixels per step: compare, movemask and a permutation table.
+	THRESHOLD_AVX512   ///< 16 pixels per step: compare into a mask and compress-store.
+};
+
+/// @brief ThresholdKernel finds the pixels of a response row that pass the corner test of CornerDetection:
+/// the response is at least a minimum and at least the maximum of its neighborhood.
+/// The columns of passing pixels are written contiguously (compare and compact). The instruction set is chosen
+/// at run time from the CPU features, with a scalar fallback; all paths return identical results.
+class ThresholdKernel {
+public:
+	/// @brief Compacts the passing columns of one row.
+	/// @param response The response row.
+	/// @param maximum The neighborhood maxima row (may equal response to skip suppression).
+	/// @param width The number of pixels in the row.
+	/// @param minResponse The minimum response.
+	/// @param columns The output; it must have room for width + 16 values, as vector paths store whole blocks.
+	/// @param path The instruction set path (default is THRESHOLD_AUTO; an unsupported path falls back to scalar).
+	/// @return The number of passing columns written to the output.
+	static int compact(const float*, const float*, int, float, int*, ThresholdPath = THRESHOLD_AUTO);
+
+	/// @brief Checks whether the CPU supports a path.
+	/// @param path The path.
+	/// @return True if compact() can run the path.
+	static bool isSupported(ThresholdPath);
+
+	/// @brief Gets the path THRESHOLD_AUTO selects on this CPU.
+	/// @return The fastest supported path.
+	static ThresholdPath bestPath();
+
+	/// @brief Gets the name of a path.
+	/// @param path The path.
+	/// @return The name (e.g. "AVX2").
+	static string pathName(ThresholdPath);
+};
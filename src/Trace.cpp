@@ -0,0 +1,129 @@
+// Author: Burak Özdemir
+#include "Trace.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+	/// @brief A finished span.
+	struct TraceEvent {
+		const char* name;
+		int64_t start;
+		int64_t end;
+	};
+
+	/// @brief Ring buffer of the spans of one thread.
+	/// The mutex is only contended while the trace is exported or cleared.
+	struct ThreadBuffer {
+		mutex lock;
+		vector<TraceEvent> events;
+		size_t next = 0;
+		bool wrapped = false;
+		unsigned threadIndex = 0;
+	};
+
+	/// @brief All thread buffers. Buffers outlive their threads so their spans can still be exported.
+	mutex registryLock;
+	vector<shared_ptr<ThreadBuffer>> registry;
+	size_t bufferCapacity = 1 << 16;
+
+	/// @brief Gets the ring buffer of the calling thread, registering it on first use.
+	ThreadBuffer& threadBuffer() {
+		thread_local shared_ptr<ThreadBuffer> buffer;
+		if (!buffer) {
+			buffer = make_shared<ThreadBuffer>();
+			lock_guard<mutex> guard(registryLock);
+			buffer->events.resize(bufferCapacity);
+			buffer->threadIndex = unsigned(registry.size()) + 1;
+			registry.push_back(buffer);
+		}
+		return *buffer;
+	}
+
+	/// @brief Writes a span name as a JSON string.
+	void writeJsonString(ofstream& file, const char* s) {
+		file << '"';
+		for (; *s; ++s) {
+			if (*s == '"' || *s == '\\')
+				file << '\\';
+			file << *s;
+		}
+		file << '"';
+	}
+}
+
+/// @details Tracing starts disabled.
+atomic<bool> Trace::enabled(false);
+
+/// @details This static function turns recording of spans on or off.
+void Trace::enable(bool on) {
+	enabled.store(on, memory_order_relaxed);
+}
+
+/// @details This static function sets the capacity of ring buffers created afterwards.
+void Trace::setBufferCapacity(size_t capacity) {
+	lock_guard<mutex> guard(registryLock);
+	bufferCapacity = capacity > 0 ? capacity : 1;
+}
+
+/// @details This static function stores a span in the ring buffer of the calling thread, overwriting the oldest span when full.
+void Trace::record(const char* name, int64_t start, int64_t end) {
+	ThreadBuffer& buffer = threadBuffer();
+	lock_guard<mutex> guard(buffer.lock);
+	buffer.events[buffer.next] = { name, start, end };
+	if (++buffer.next == buffer.events.size()) {
+		buffer.next = 0;
+		buffer.wrapped = true;
+	}
+}
+
+/// @details This static function writes every recorded span as a complete ("X") Chrome trace event.
+/// Timestamps are written in microseconds relative to the earliest recorded span.
+bool Trace::writeChromeTrace(string path) {
+	ofstream file(path);
+	if (!file)
+		return false;
+
+	lock_guard<mutex> guard(registryLock);
+	int64_t origin = INT64_MAX;
+	for (auto& buffer : registry) {
+		lock_guard<mutex> bufferGuard(buffer->lock);
+		size_t n = buffer->wrapped ? buffer->events.size() : buffer->next;
+		for (size_t i = 0; i < n; ++i)
+			origin = min(origin, buffer->events[i].start);
+	}
+
+	file << fixed << setprecision(3) << "{\"traceEvents\":[";
+	bool first = true;
+	for (auto& buffer : registry) {
+		lock_guard<mutex> bufferGuard(buffer->lock);
+		size_t n = buffer->wrapped ? buffer->events.size() : buffer->next;
+		size_t begin = buffer->wrapped ? buffer->next : 0;
+		for (size_t k = 0; k < n; ++k) {
+			const TraceEvent& event = buffer->events[(begin + k) % buffer->events.size()];
+			file << (first ? "\n" : ",\n") << "{\"name\":";
+			writeJsonString(file, event.name);
+			file << ",\"cat\":\"ipa\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+				<< ",\"ts\":" << (event.start - origin) / 1000.0
+				<< ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+			first = false;
+		}
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return bool(file);
+}
+
+/// @details This static function drops the recorded spans of all threads. The buffers stay allocated.
+void Trace::clear() {
+	lock_guard<mutex> guard(registryLock);
+	for (auto& buffer : registry) {
+		lock_guard<mutex> bufferGuard(buffer->lock);
+		buffer->next = 0;
+		buffer->wrapped = false;
+	}
+}
@@ -0,0 +1,86 @@
+// Author: Burak Özdemir
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/// @brief Trace class for recording scoped timing spans of image processing operations.
+/// Spans are stored in per-thread ring buffers and can be exported as Chrome trace JSON
+/// (chrome://tracing or https://ui.perfetto.dev). Tracing is disabled by default; a disabled
+/// span costs a single relaxed atomic load. Defining IPA_DISABLE_TRACING removes the spans at compile time.
+class Trace {
+public:
+	/// @brief Enables or disables recording of trace spans.
+	/// @param enabled True to record spans, false to ignore them.
+	static void enable(bool = true);
+
+	/// @brief Checks whether trace spans are being recorded.
+	/// @return True if tracing is enabled.
+	static bool isEnabled() { return enabled.load(memory_order_relaxed); }
+
+	/// @brief Sets the number of spans kept per thread. Older spans are overwritten when a buffer is full.
+	/// Only buffers of threads that record their first span afterwards use the new capacity.
+	/// @param capacity The number of spans per thread ring buffer.
+	static void setBufferCapacity(size_t);
+
+	/// @brief Records a finished span into the ring buffer of the calling thread.
+	/// @param name The name of the span (must outlive the trace, e.g. a string literal).
+	/// @param start The start timestamp in nanoseconds (see now()).
+	/// @param end The end timestamp in nanoseconds (see now()).
+	static void record(const char*, int64_t, int64_t);
+
+	/// @brief Writes all recorded spans as Chrome trace event JSON.
+	/// @param path The file path of the JSON file.
+	/// @return True if the file was written.
+	static bool writeChromeTrace(string);
+
+	/// @brief Removes all recorded spans.
+	static void clear();
+
+	/// @brief Gets the current timestamp of the trace clock.
+	/// @return The timestamp in nanoseconds.
+	static int64_t now() {
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+private:
+	/// @brief Whether spans are recorded.
+	static atomic<bool> enabled;
+};
+
+/// @brief TraceScope records a span from its construction to its destruction.
+/// Use it through the TRACE_SCOPE macro at the beginning of an operation.
+class TraceScope {
+public:
+	/// @brief Starts a span when tracing is enabled.
+	/// @param name The name of the span (must be a string literal).
+	explicit TraceScope(const char* spanName) : name(Trace::isEnabled() ? spanName : nullptr), start(name ? Trace::now() : 0) {}
+
+	/// @brief Ends the span and records it.
+	~TraceScope() {
+		if (name)
+			Trace::record(name, start, Trace::now());
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	/// @brief Name of the span, nullptr when tracing was disabled at construction.
+	const char* name;
+	/// @brief Start timestamp of the span in nanoseconds.
+	int64_t start;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifdef IPA_DISABLE_TRACING
+#define TRACE_SCOPE(name) ((void)0)
+#else
+/// @brief Records a trace span named name for the rest of the enclosing scope.
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#endif
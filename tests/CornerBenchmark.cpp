@@ -0,0 +1,156 @@
+// Author: Burak Özdemir
+// Compares the corner detectors on the same images: detection time and repeatability under rotation, scaling and noise.
+// Usage: CornerBenchmark [image...]; without images three synthetic 1280x720 scenes are used.
+#include "CornerDetection.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+	/// @brief Number of strongest corners detected per image.
+	const size_t cornerCount = 500;
+	/// @brief Distance in pixels within which a corner counts as found again.
+	const float matchRadius = 2.0f;
+	/// @brief Corners mapped closer than this to the image border are not counted (they may leave the image).
+	const int borderMargin = 8;
+	const int repetitions = 5;
+
+	/// @brief A distorted copy of an image: an affine map of the positions and additive Gaussian noise.
+	struct Distortion {
+		string name;
+		double angle;
+		double scale;
+		double noise;
+	};
+
+	/// @brief Draws filled rectangles, circles and lines of random gray levels, slightly blurred, with a little noise.
+	Mat makeScene(Size size, uint64_t seed) {
+		RNG rng(seed);
+		Mat scene(size, CV_8UC1, Scalar(rng.uniform(0, 255)));
+		for (int i = 0; i < size.area() / 6000; ++i) {
+			Point corner(rng.uniform(0, size.width), rng.uniform(0, size.height));
+			Scalar level(rng.uniform(0, 255));
+			if (i % 5 == 0)
+				circle(scene, corner, rng.uniform(5, 40), level, FILLED);
+			else if (i % 5 == 1)
+				line(scene, corner, corner + Point(rng.uniform(-100, 100), rng.uniform(-100, 100)), level, rng.uniform(1, 4));
+			else
+				rectangle(scene, corner, corner + Point(rng.uniform(8, 90), rng.uniform(8, 90)), level, FILLED);
+		}
+		GaussianBlur(scene, scene, Size(3, 3), 0.8);
+		Mat noise(size, CV_8UC1);
+		rng.fill(noise, RNG::UNIFORM, 0, 4);
+		return scene + noise;
+	}
+
+	/// @brief Applies a distortion to an image.
+	/// @return The distorted image; transform receives the 2x3 map from image to distorted positions.
+	Mat distort(const Mat& image, const Distortion& distortion, Mat& transform, uint64_t seed) {
+		Point2f center(image.cols / 2.0f, image.rows / 2.0f);
+		transform = getRotationMatrix2D(center, distortion.angle, distortion.scale);
+		Mat warped;
+		warpAffine(image, warped, transform, image.size(), INTER_LINEAR, BORDER_REFLECT_101);
+		if (distortion.noise > 0) {
+			Mat noise(image.size(), CV_32FC(image.channels()));
+			RNG rng(seed);
+			rng.fill(noise, RNG::NORMAL, 0, distortion.noise);
+			Mat sum;
+			warped.convertTo(sum, CV_32F);
+			sum += noise;
+			sum.convertTo(warped, image.type());
+		}
+		return warped;
+	}
+
+	/// @brief Detects the strongest corners of an image several times.
+	/// @return The median time in milliseconds.
+	double detect(CornerDetection& cd, const Mat& image) {
+		vector<double> times;
+		for (int i = 0; i < repetitions; ++i) {
+			// A new image version makes findStrongestCorners compute the response again.
+			cd.setImage(image);
+			int64_t start = getTickCount();
+			cd.findStrongestCorners(cornerCount);
+			times.push_back((getTickCount() - start) * 1000.0 / getTickFrequency());
+		}
+		nth_element(times.begin(), times.begin() + repetitions / 2, times.end());
+		return times[repetitions / 2];
+	}
+
+	/// @brief Measures how many reference corners are found again in the distorted image.
+	/// @return The fraction of the reference corners mapped inside the distorted image that have a distorted corner
+	/// within matchRadius, or -1 if none is mapped inside.
+	double repeatability(const CornerSet& reference, const Mat& transform, CornerDetection& distorted, Size size) {
+		const CornerGrid& grid = distorted.getCornerIndex();
+		size_t visible = 0, repeated = 0;
+		for (size_t i = 0; i < reference.size(); ++i) {
+			const double* m = transform.ptr<double>(0);
+			const double* n = transform.ptr<double>(1);
+			Point2f p(float(m[0] * reference.x[i] + m[1] * reference.y[i] + m[2]), float(n[0] * reference.x[i] + n[1] * reference.y[i] + n[2]));
+			if (p.x < borderMargin || p.y < borderMargin || p.x >= size.width - borderMargin || p.y >= size.height - borderMargin)
+				continue;
+			visible++;
+			if (!grid.queryRadius(p, matchRadius).empty())
+				repeated++;
+		}
+		return visible > 0 ? double(repeated) / visible : -1;
+	}
+}
+
+int main(int argc, char** argv) {
+	vector<Mat> images;
+	for (int i = 1; i < argc; ++i) {
+		images.push_back(imread(argv[i], IMREAD_COLOR));
+		if (images.back().empty()) {
+			cerr << "cannot read " << argv[i] << endl;
+			return 1;
+		}
+	}
+	if (images.empty())
+		for (uint64_t seed = 0; seed < 3; ++seed)
+			images.push_back(makeScene(Size(1280, 720), seed));
+	setNumThreads(1);
+
+	const CornerMethod methods[] = { CORNER_HARRIS, CORNER_HARRIS_FIXED, CORNER_SHI_TOMASI, CORNER_FAST };
+	const char* names[] = { "harris", "harris-fixed", "shi-tomasi", "fast" };
+	const Distortion distortions[] = {
+		{ "rotate 10 scale 0.9", 10, 0.9, 0 },
+		{ "noise 8", 0, 1, 8 },
+		{ "rotate 30 + noise 8", 30, 1, 8 },
+	};
+	const int distortionCount = int(sizeof(distortions) / sizeof(distortions[0]));
+
+	cout << fixed << setprecision(2) << "one thread, " << cornerCount << " strongest corners, match radius " << matchRadius << " px" << endl;
+	for (int m = 0; m < 4; ++m) {
+		CornerDetection reference(string(names[m]) + "_reference", images[0]);
+		CornerDetection distorted(string(names[m]) + "_distorted", images[0]);
+		reference.setCornerMethod(methods[m]);
+		distorted.setCornerMethod(methods[m]);
+
+		double milliseconds = 0, megapixels = 0;
+		vector<double> sums(distortionCount, 0);
+		vector<int> counts(distortionCount, 0);
+		for (size_t i = 0; i < images.size(); ++i) {
+			milliseconds += detect(reference, images[i]);
+			megapixels += images[i].total() / 1e6;
+			for (int d = 0; d < distortionCount; ++d) {
+				Mat transform;
+				distorted.setImage(distort(images[i], distortions[d], transform, i * distortionCount + d));
+				distorted.findStrongestCorners(cornerCount);
+				double r = repeatability(reference.getCorners(), transform, distorted, images[i].size());
+				if (r >= 0) {
+					sums[d] += r;
+					counts[d]++;
+				}
+			}
+		}
+
+		cout << setw(13) << left << names[m] << right << setw(8) << milliseconds / images.size() << " ms/image"
+			<< setw(8) << megapixels / (milliseconds / 1000) << " Mpx/s";
+		for (int d = 0; d < distortionCount; ++d)
+			cout << "  " << distortions[d].name << ": " << (counts[d] ? 100 * sums[d] / counts[d] : 0.0) << "%";
+		cout << endl;
+	}
+	return 0;
+}
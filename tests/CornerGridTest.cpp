@@ -0,0 +1,80 @@
+// Author: Burak Özdemir
+// Checks that a CornerGrid following prefixes of a candidate list answers queries like a grid built from scratch.
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+namespace {
+
+	int failures = 0;
+
+	void expect(bool condition, const string& message) {
+		if (!condition) {
+			cerr << "FAIL: " << message << endl;
+			failures++;
+		}
+	}
+
+	vector<size_t> sorted(vector<size_t> indices) {
+		sort(indices.begin(), indices.end());
+		return indices;
+	}
+
+	/// @brief Compares the queries of the incremental and the rebuilt grid at random places.
+	bool sameAnswers(const CornerGrid& incremental, const CornerGrid& rebuilt, const CornerSet& corners, mt19937& generator) {
+		for (int q = 0; q < 20; ++q) {
+			Rect rect(int(generator() % 2200) - 100, int(generator() % 1700) - 100, int(generator() % 400), int(generator() % 400));
+			if (sorted(incremental.queryRect(rect)) != sorted(rebuilt.queryRect(rect)))
+				return false;
+			Point2f center(float(generator() % 2000), float(generator() % 1500));
+			float radius = float(generator() % 200);
+			if (sorted(incremental.queryRadius(center, radius)) != sorted(rebuilt.queryRadius(center, radius)))
+				return false;
+			// Nearest neighbors at equal distances may come in any order, so only the distances are compared.
+			size_t k = generator() % 12;
+			vector<size_t> a = incremental.nearest(center, k), b = rebuilt.nearest(center, k);
+			if (a.size() != b.size())
+				return false;
+			auto distance2 = [&](size_t i) { float dx = corners.x[i] - center.x, dy = corners.y[i] - center.y; return dx * dx + dy * dy; };
+			for (size_t j = 0; j < a.size(); ++j)
+				if (distance2(a[j]) != distance2(b[j]))
+					return false;
+		}
+		return true;
+	}
+}
+
+int main() {
+	mt19937 generator(38);
+	for (int trial = 0; trial < 40; ++trial) {
+		shared_ptr<CornerSet> candidates = make_shared<CornerSet>();
+		int n = int(generator() % 3000);
+		for (int i = 0; i < n; ++i)
+			candidates->push_back(int(generator() % 2000), int(generator() % 1500), 0.0f);
+		shared_ptr<const CornerSet> source = candidates;
+
+		CornerGrid incremental;
+		for (int step = 0; step < 25; ++step) {
+			// Now and then the candidate list is replaced, as after a new image.
+			if (step % 7 == 6)
+				source = make_shared<const CornerSet>(*candidates);
+			// The corners above a random threshold: a prefix of the candidates, longer or shorter than the last one.
+			size_t count = generator() % (n + 1);
+			shared_ptr<CornerSet> prefix = make_shared<CornerSet>();
+			for (size_t i = 0; i < count; ++i)
+				prefix->push_back(source->x[i], source->y[i], 0.0f);
+
+			incremental.buildPrefix(prefix, source);
+			CornerGrid rebuilt;
+			rebuilt.build(prefix);
+			expect(incremental.isBuiltFrom(prefix), "the incremental grid indexes the new prefix");
+			expect(sameAnswers(incremental, rebuilt, *prefix, generator),
+				"trial " + to_string(trial) + " step " + to_string(step) + ": a prefix of " + to_string(count) + " corners answers like a rebuilt grid");
+		}
+	}
+
+	if (failures == 0)
+		cout << "PASS" << endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+// Author: Burak Özdemir
+// Checks that DetectionCache keys depend on the pixels only, not on how the rows are laid out in memory.
+#include "DetectionCache.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	void expect(bool condition, const string& message) {
+		if (!condition) {
+			cerr << "FAIL: " << message << endl;
+			failures++;
+		}
+	}
+}
+
+int main() {
+	// hashRows over padded rows equals hashBytes over the same rows stored contiguously, for every row length
+	// around the 32-byte block size of the hash.
+	mt19937 generator(34);
+	bool rowsMatch = true;
+	for (int trial = 0; trial < 2000; ++trial) {
+		int rows = int(generator() % 9);
+		size_t rowBytes = generator() % 70;
+		size_t step = rowBytes + generator() % 40;
+		vector<unsigned char> contiguous(rows * rowBytes), padded(rows * step);
+		for (auto& byte : padded)
+			byte = (unsigned char)generator();
+		for (int r = 0; r < rows; ++r)
+			copy(padded.begin() + r * step, padded.begin() + r * step + rowBytes, contiguous.begin() + r * rowBytes);
+		rowsMatch &= DetectionCache::hashRows(padded.data(), rowBytes, step, rows, trial)
+			== DetectionCache::hashBytes(contiguous.data(), contiguous.size(), trial);
+	}
+	expect(rowsMatch, "hashRows over padded rows equals hashBytes over the contiguous rows");
+
+	Mat image(480, 640, CV_8UC3);
+	randu(image, Scalar::all(0), Scalar::all(255));
+	Mat roi = image(Rect(13, 7, 301, 203));
+	expect(!roi.isContinuous(), "the ROI is not continuous");
+	expect(DetectionCache::makeKey(roi, "p") == DetectionCache::makeKey(roi.clone(), "p"), "an ROI and its clone have the same key");
+
+	// A padded buffer (row step larger than the row) holding the same pixels.
+	size_t step = image.cols * image.elemSize() + 24;
+	vector<unsigned char> buffer(step * image.rows, 0xAB);
+	Mat padded(image.rows, image.cols, image.type(), buffer.data(), step);
+	image.copyTo(padded);
+	expect(DetectionCache::makeKey(padded, "p") == DetectionCache::makeKey(image, "p"), "a padded image and its continuous copy have the same key");
+
+	Mat changed = roi.clone();
+	changed.at<Vec3b>(100, 100)[0] ^= 1;
+	expect(DetectionCache::makeKey(changed, "p") != DetectionCache::makeKey(roi, "p"), "a changed pixel changes the key");
+	expect(DetectionCache::makeKey(roi, "p") != DetectionCache::makeKey(roi, "q"), "other parameters change the key");
+
+	if (failures == 0)
+		cout << "PASS" << endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+// Author: Burak Özdemir
+// Checks that the fixed-point Harris response stays within a tolerance of the float cornerHarris response.
+#include "CornerDetectors.h"
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+	/// @brief Largest difference, in levels of 0..255, allowed between the scaled fixed-point and the normalized float response.
+	/// The shifts of the window sums and of the response and the rounding down of the integer scaling cost up to 2 levels.
+	const double tolerance = 2.0 + 1e-3;
+
+	int failures = 0;
+
+	/// @brief Draws a scene of filled rectangles of random gray levels with a little noise.
+	Mat makeRectangles(Size size, uint64_t seed) {
+		RNG rng(seed);
+		Mat scene = Mat::zeros(size, CV_8UC1);
+		for (int i = 0; i < size.area() / 2000; ++i) {
+			Point corner(rng.uniform(0, size.width), rng.uniform(0, size.height));
+			Point opposite = corner + Point(rng.uniform(5, 60), rng.uniform(5, 60));
+			rectangle(scene, corner, opposite, Scalar(rng.uniform(0, 255)), FILLED);
+		}
+		Mat noise(size, CV_8UC1);
+		rng.fill(noise, RNG::UNIFORM, 0, 8);
+		return scene + noise;
+	}
+
+	/// @brief Draws rectangles of gray levels 100 to 110 on a level 100 background, without noise. The window sums
+	/// are far below their theoretical maximum, so fixed shifts would drop most of the response.
+	Mat makeLowContrast(Size size, uint64_t seed) {
+		RNG rng(seed);
+		Mat scene(size, CV_8UC1, Scalar(100));
+		for (int i = 0; i < size.area() / 2000; ++i) {
+			Point corner(rng.uniform(0, size.width), rng.uniform(0, size.height));
+			Point opposite = corner + Point(rng.uniform(5, 60), rng.uniform(5, 60));
+			rectangle(scene, corner, opposite, Scalar(rng.uniform(100, 111)), FILLED);
+		}
+		return scene;
+	}
+
+	/// @brief Draws a product of two sine gratings with Gaussian noise, a texture without flat regions.
+	Mat makeTexture(Size size, uint64_t seed) {
+		RNG rng(seed);
+		double f[4];
+		for (double& frequency : f)
+			frequency = rng.uniform(0.05, 0.3);
+		Mat scene(size, CV_8UC1);
+		for (int y = 0; y < size.height; ++y)
+			for (int x = 0; x < size.width; ++x)
+				scene.at<uchar>(y, x) = saturate_cast<uchar>(128 + 50 * sin(x * f[0] + y * f[1]) * cos(x * f[2] - y * f[3]) + rng.gaussian(12));
+		return scene;
+	}
+}
+
+int main() {
+	unique_ptr<CornerDetector> floating = CornerDetector::create(CORNER_HARRIS);
+	unique_ptr<CornerDetector> fixed = CornerDetector::create(CORNER_HARRIS_FIXED);
+	const int shapes[][2] = { {2, 1}, {2, 3}, {3, 3}, {5, 3}, {2, 5} };
+
+	const char* sceneNames[] = { "rectangles", "low contrast", "texture" };
+	Mat (*const scenes[])(Size, uint64_t) = { makeRectangles, makeLowContrast, makeTexture };
+
+	double worst = 0;
+	for (int run = 0; run < 18; ++run) {
+		int kind = run / 6;
+		uint64_t seed = run % 6;
+		Mat gray = scenes[kind](Size(640, 480), seed);
+		for (const auto& shape : shapes) {
+			CornerParameters parameters;
+			parameters.blockSize = shape[0];
+			parameters.aperatureSize = shape[1];
+
+			Mat floatResponse, floatScaled;
+			floating->computeResponse(gray, floatResponse, parameters);
+			normalize(floatResponse, floatScaled, 0, 255, NORM_MINMAX, CV_32FC1);
+
+			Mat fixedResponse, fixedScaled;
+			fixed->computeResponse(gray, fixedResponse, parameters);
+			if (fixedResponse.type() != CV_32SC1) {
+				cerr << "FAIL: " << sceneNames[kind] << " blockSize " << shape[0] << " aperture " << shape[1] << " fell back to the float path" << endl;
+				failures++;
+				continue;
+			}
+			CornerDetector::scaleTo8Bit(fixedResponse, fixedScaled);
+			fixedScaled.convertTo(fixedScaled, CV_32F);
+
+			double difference = norm(floatScaled, fixedScaled, NORM_INF);
+			worst = max(worst, difference);
+			if (difference > tolerance) {
+				cerr << "FAIL: " << sceneNames[kind] << " seed " << seed << " blockSize " << shape[0] << " aperture " << shape[1]
+					<< ": difference " << difference << " levels" << endl;
+				failures++;
+			}
+		}
+	}
+
+	cout << "largest difference: " << worst << " levels" << endl;
+	if (failures == 0)
+		cout << "PASS" << endl;
+	return failures == 0 ? 0 : 1;
+}
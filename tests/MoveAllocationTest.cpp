@@ -0,0 +1,80 @@
+// Author: Burak Özdemir
+// Counts the image buffers a transform chain allocates on temporaries (the && overloads).
+#include "CommonProcesses.h"
+#include <atomic>
+
+namespace {
+
+	/// @brief Forwards to the standard allocator and counts the buffers it allocates.
+	class CountingAllocator : public MatAllocator {
+	public:
+		mutable atomic<int> allocations{0};
+
+		UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, AccessFlag flags, UMatUsageFlags usageFlags) const override {
+			if (data == nullptr)
+				allocations++;
+			return Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+		}
+
+		bool allocate(UMatData* data, AccessFlag accessFlags, UMatUsageFlags usageFlags) const override {
+			return Mat::getStdAllocator()->allocate(data, accessFlags, usageFlags);
+		}
+
+		void deallocate(UMatData* data) const override {
+			Mat::getStdAllocator()->deallocate(data);
+		}
+	};
+
+	int failures = 0;
+
+	void expect(bool condition, const string& message) {
+		if (!condition) {
+			cerr << "FAIL: " << message << endl;
+			failures++;
+		}
+	}
+
+	/// @brief Runs the chain of the user-028 example on an lvalue source object.
+	CommonProcesses runChain(CommonProcesses& cp) {
+		return cp.RGB2Gray().erosion().dilation().normalizeImage(CV_8U).rescaleImage(120, 160);
+	}
+}
+
+int main() {
+	Mat color(480, 640, CV_8UC3);
+	randu(color, Scalar::all(0), Scalar::all(255));
+	CommonProcesses cp("alloc", color);
+
+	CountingAllocator counter;
+	MatAllocator* previous = Mat::getDefaultAllocator();
+	Mat::setDefaultAllocator(&counter);
+
+	// The first run builds the static morphology kernel, so it is not counted.
+	runChain(cp);
+
+	counter.allocations = 0;
+	CommonProcesses chained = runChain(cp);
+	int chainAllocations = counter.allocations;
+
+	counter.allocations = 0;
+	CommonProcesses gray = cp.RGB2Gray();
+	CommonProcesses eroded = gray.erosion();
+	CommonProcesses dilated = eroded.dilation();
+	CommonProcesses normalized = dilated.normalizeImage(CV_8U);
+	CommonProcesses resized = normalized.rescaleImage(120, 160);
+	int lvalueAllocations = counter.allocations;
+
+	Mat::setDefaultAllocator(previous);
+
+	cout << "temporary chain: " << chainAllocations << " allocations, lvalue chain: " << lvalueAllocations << " allocations" << endl;
+	expect(chainAllocations <= 2, "a chain on temporaries allocates at most the gray and the resized image");
+	expect(lvalueAllocations > chainAllocations, "the lvalue overloads allocate one image per step");
+	expect(chained.getImage().size() == Size(160, 120) && chained.getImage().type() == CV_8UC1, "the chain result has the requested size and type");
+	expect(countNonZero(chained.getImage() != resized.getImage()) == 0, "both chains produce the same image");
+	expect(cp.closeImage().getID() == "alloc_closed", "closeImage names its result _closed");
+	expect(CommonProcesses("temporary", color).closeImage().getID() == "temporary_closed", "closeImage on a temporary names its result _closed");
+
+	if (failures == 0)
+		cout << "PASS" << endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+// Author: Burak Özdemir
+// Checks the orientations and the orientation histogram of SegmentStats, including segments drawn right to left.
+#include "SegmentStats.h"
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+	int failures = 0;
+
+	void expect(bool condition, const string& message) {
+		if (!condition) {
+			cerr << "FAIL: " << message << endl;
+			failures++;
+		}
+	}
+}
+
+int main() {
+	SegmentSet segments;
+	segments.push_back(Vec4i(10, 50, 100, 50));   // horizontal, left to right
+	segments.push_back(Vec4i(100, 50, 10, 50));   // horizontal, right to left
+	segments.push_back(Vec4i(20, 10, 20, 90));    // vertical, downwards
+	segments.push_back(Vec4i(20, 90, 20, 10));    // vertical, upwards
+	segments.push_back(Vec4i(0, 0, 40, 40));      // diagonal
+	segments.push_back(Vec4i(40, 40, 0, 0));      // diagonal, reversed
+
+	SegmentStats stats(segments, 18);
+	const float expected[] = { 0, 0, 90, 90, 45, 45 };
+	for (size_t i = 0; i < stats.size(); ++i)
+		expect(abs(stats.orientation[i] - expected[i]) < 0.1f,
+			"segment " + to_string(i) + " has orientation " + to_string(stats.orientation[i]) + ", expected " + to_string(expected[i]));
+	expect(stats.orientationHistogram[0] == 2, "both horizontal segments fall into bin 0");
+	expect(stats.orientationHistogram[9] == 2, "both vertical segments fall into bin 9");
+	expect(stats.orientationHistogram[4] == 2, "both diagonal segments fall into bin 4");
+
+	// Every direction, in both senses, stays within [0, 180).
+	SegmentSet around;
+	for (int angle = 0; angle < 360; ++angle) {
+		double radians = angle * CV_PI / 180;
+		around.push_back(Vec4i(500, 500, 500 + cvRound(400 * cos(radians)), 500 + cvRound(400 * sin(radians))));
+	}
+	SegmentStats aroundStats(around, 36);
+	bool inRange = true;
+	for (float orientation : aroundStats.orientation)
+		inRange &= orientation >= 0 && orientation < 180;
+	expect(inRange, "all orientations are in [0, 180)");
+
+	if (failures == 0)
+		cout << "PASS" << endl;
+	return failures == 0 ? 0 : 1;
+}
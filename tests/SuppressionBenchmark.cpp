@@ -0,0 +1,79 @@
+// Author: Burak Özdemir
+// Measures what non-maximum suppression costs and how many corners it removes, on one thread.
+// Usage: SuppressionBenchmark [image]; without an image a synthetic 1920x1080 scene is used.
+#include "CornerDetection.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+	const int repetitions = 9;
+
+	/// @brief Draws a scene of filled rectangles and circles of random gray levels with a little noise.
+	Mat makeScene(Size size, uint64_t seed) {
+		RNG rng(seed);
+		Mat scene = Mat::zeros(size, CV_8UC1);
+		for (int i = 0; i < size.area() / 4000; ++i) {
+			Point corner(rng.uniform(0, size.width), rng.uniform(0, size.height));
+			if (i % 4 == 0)
+				circle(scene, corner, rng.uniform(5, 40), Scalar(rng.uniform(0, 255)), FILLED);
+			else
+				rectangle(scene, corner, corner + Point(rng.uniform(5, 80), rng.uniform(5, 80)), Scalar(rng.uniform(0, 255)), FILLED);
+		}
+		Mat noise(size, CV_8UC1);
+		rng.fill(noise, RNG::UNIFORM, 0, 8);
+		return scene + noise;
+	}
+
+	double milliseconds(int64_t ticks) {
+		return ticks * 1000.0 / getTickFrequency();
+	}
+
+	/// @brief Times findCorners after a change of the suppression radius, which recomputes the neighborhood maxima
+	/// and the candidate index but not the response.
+	/// @return The median time in milliseconds.
+	double timeRadius(CornerDetection& cd, int radius) {
+		vector<double> times;
+		for (int i = 0; i < repetitions; ++i) {
+			cd.setSuppressionRadius(radius == 0 ? 1 : 0);
+			cd.findCorners();
+			cd.setSuppressionRadius(radius);
+			int64_t start = getTickCount();
+			cd.findCorners();
+			times.push_back(milliseconds(getTickCount() - start));
+		}
+		nth_element(times.begin(), times.begin() + repetitions / 2, times.end());
+		return times[repetitions / 2];
+	}
+}
+
+int main(int argc, char** argv) {
+	Mat image = argc > 1 ? imread(argv[1], IMREAD_GRAYSCALE) : makeScene(Size(1920, 1080), 39);
+	if (image.empty()) {
+		cerr << "cannot read " << argv[1] << endl;
+		return 1;
+	}
+	setNumThreads(1);
+
+	const CornerMethod methods[] = { CORNER_HARRIS, CORNER_HARRIS_FIXED, CORNER_SHI_TOMASI, CORNER_FAST };
+	const char* names[] = { "harris", "harris-fixed", "shi-tomasi", "fast" };
+	for (int m = 0; m < 4; ++m) {
+		CornerDetection cd(names[m], image, 100);
+		cd.setCornerMethod(methods[m]);
+		cd.setSuppressionRadius(0);
+		int64_t start = getTickCount();
+		cd.findCorners();
+		double full = milliseconds(getTickCount() - start);
+		size_t unsuppressed = cd.getCorners().size();
+
+		double without = timeRadius(cd, 0);
+		double with = timeRadius(cd, 1);
+		size_t suppressed = cd.getCorners().size();
+
+		cout << names[m] << " " << image.cols << "x" << image.rows << ": full detection " << full << " ms, candidate scan "
+			<< without << " ms without and " << with << " ms with 3x3 suppression (+" << with - without << " ms); corners above 100: "
+			<< unsuppressed << " without, " << suppressed << " with suppression ("
+			<< (unsuppressed ? 100.0 * (unsuppressed - suppressed) / unsuppressed : 0.0) << "% removed)" << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,70 @@
+// Author: Burak Özdemir
+// Compares every supported ThresholdKernel path with a reference on random rows, for all tail widths 0-15.
+#include "ThresholdKernel.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	/// @brief The corner test of CornerDetection, one pixel at a time.
+	vector<int> reference(const vector<float>& response, const vector<float>& maximum, float minResponse) {
+		vector<int> columns;
+		for (int x = 0; x < int(response.size()); ++x)
+			if (response[x] >= minResponse && response[x] >= maximum[x])
+				columns.push_back(x);
+		return columns;
+	}
+
+	/// @brief Runs one path on a row and compares it with the reference.
+	void check(ThresholdPath path, const vector<float>& response, const vector<float>& maximum, float minResponse, bool aliased) {
+		int width = int(response.size());
+		vector<int> expected = reference(response, aliased ? response : maximum, minResponse);
+		vector<int> columns(width + 16, -1);
+		int n = ThresholdKernel::compact(response.data(), aliased ? response.data() : maximum.data(), width, minResponse, columns.data(), path);
+		if (n != int(expected.size()) || !equal(expected.begin(), expected.end(), columns.begin())) {
+			cerr << "FAIL: " << ThresholdKernel::pathName(path) << " width " << width << (aliased ? " (no suppression)" : "")
+				<< ": " << n << " columns, expected " << expected.size() << endl;
+			failures++;
+		}
+	}
+}
+
+int main() {
+	vector<ThresholdPath> paths = { THRESHOLD_SCALAR, THRESHOLD_AVX2, THRESHOLD_AVX512 };
+	for (ThresholdPath path : paths)
+		cout << ThresholdKernel::pathName(path) << (ThresholdKernel::isSupported(path) ? " supported" : " not supported, skipped") << endl;
+	cout << "auto path: " << ThresholdKernel::pathName(ThresholdKernel::bestPath()) << endl;
+
+	mt19937 generator(44);
+	uniform_int_distribution<int> level(0, 255);
+	uniform_int_distribution<int> offset(-2, 2);
+	const float minResponse = 96.0f;
+
+	for (int blocks = 0; blocks <= 4; ++blocks) {
+		for (int tail = 0; tail < 16; ++tail) {
+			int width = 16 * blocks + tail;
+			for (int trial = 0; trial < 50; ++trial) {
+				vector<float> response(width), maximum(width);
+				for (int x = 0; x < width; ++x) {
+					// Whole levels make ties with the minimum and with the neighborhood maximum frequent.
+					response[x] = float(level(generator));
+					maximum[x] = trial % 2 == 0 ? response[x] + float(max(offset(generator), 0)) : response[x] + float(offset(generator));
+				}
+				for (ThresholdPath path : paths) {
+					if (!ThresholdKernel::isSupported(path))
+						continue;
+					check(path, response, maximum, minResponse, false);
+					check(path, response, maximum, minResponse, true);
+				}
+			}
+		}
+	}
+
+	if (failures == 0)
+		cout << "PASS" << endl;
+	return failures == 0 ? 0 : 1;
+}